@@ -59,25 +59,25 @@ bool Application::init()
 
 bool Application::update()
 {
-	BEGIN_TIMED_BLOCK(Frame);
+	{
+		PROFILE_SCOPE("Frame");
 
-	if (doStart() == false) return false;
+		if (doStart() == false) return false;
 
-	if (doPreUpdate() == false) return false;
-	
-	if (doUpdate() == false) return false;
+		if (doPreUpdate() == false) return false;
 
-	if (doGui() == false) return false;
+		if (doUpdate() == false) return false;
 
-	if (doPostUpdate() == false) return false;
+		if (doGui() == false) return false;
 
-	if (doStop() == false) return false;
+		if (doPostUpdate() == false) return false;
 
-	modRender->present();
+		if (doStop() == false) return false;
 
-	END_TIMED_BLOCK(Frame);
+		modRender->present();
+	}
 
-	END_PROFILING_FRAME();
+	PROFILE_END_FRAME();
 
 	return (exitFlag == false);
 }
@@ -126,7 +126,7 @@ bool Application::doStart()
 
 bool Application::doPreUpdate()
 {
-	BEGIN_TIMED_BLOCK(PreUpdate);
+	PROFILE_SCOPE("PreUpdate");
 
 	for (int i = 0; i < numModules; ++i)
 	{
@@ -138,14 +138,12 @@ bool Application::doPreUpdate()
 		}
 	}
 
-	END_TIMED_BLOCK(PreUpdate);
-
 	return true;
 }
 
 bool Application::doUpdate()
 {
-	BEGIN_TIMED_BLOCK(Update);
+	PROFILE_SCOPE("Update");
 
 	static float accumulator = 0.0f;
 
@@ -177,14 +175,12 @@ bool Application::doUpdate()
 	// between the previous state and the current state using this
 	// deviation in time.
 
-	END_TIMED_BLOCK(Update);
-
 	return true;
 }
 
 bool Application::doGui()
 {
-	BEGIN_TIMED_BLOCK(GuiUpdate);
+	PROFILE_SCOPE("GuiUpdate");
 
 	if (modUI->isEnabled())
 	{
@@ -199,14 +195,12 @@ bool Application::doGui()
 		}
 	}
 
-	END_TIMED_BLOCK(GuiUpdate);
-
 	return true;
 }
 
 bool Application::doPostUpdate()
 {
-	BEGIN_TIMED_BLOCK(PostUpdate);
+	PROFILE_SCOPE("PostUpdate");
 
 	for (int i = 0; i < numModules; ++i)
 	{
@@ -218,8 +212,6 @@ bool Application::doPostUpdate()
 		}
 	}
 
-	END_TIMED_BLOCK(PostUpdate);
-
 	return true;
 }
 
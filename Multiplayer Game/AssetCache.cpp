@@ -0,0 +1,145 @@
+#include "Networks.h"
+#include "AssetCache.h"
+
+
+//////////////////////////////////////////////////////////////////////
+// File format
+//////////////////////////////////////////////////////////////////////
+
+// NOTE: Like the atlas, written as it is in memory and only meant to be
+// read back by the same build on the same machine.
+//   AssetCacheHeader
+//   data, at AssetCacheHeader::dataOffset
+
+static const uint32 ASSET_CACHE_MAGIC = 'ASTC';
+static const uint32 ASSET_CACHE_VERSION = 1;
+static const uint64 ASSET_CACHE_DATA_ALIGNMENT = 16;
+static const int MAX_CACHE_FILENAME_LENGTH = 256;
+
+struct AssetCacheHeader
+{
+	uint32 magic;
+	uint32 version;
+	uint32 type;
+	uint32 reserved;
+	uint64 sourceHash;
+	uint32 params[CachedAsset::MAX_PARAMS];
+	uint64 dataOffset;
+	uint64 dataSize;
+};
+
+static bool cacheFilename(const char *sourceFilename, char *cacheFilename)
+{
+	int length = sprintf_s(cacheFilename, MAX_CACHE_FILENAME_LENGTH, "%s.cache", sourceFilename);
+	return length > 0;
+}
+
+
+//////////////////////////////////////////////////////////////////////
+// CachedAsset
+//////////////////////////////////////////////////////////////////////
+
+uint64 hashFileContents(const char *filename)
+{
+	FILE *file = fopen(filename, "rb");
+	if (file == nullptr)
+	{
+		return 0;
+	}
+
+	uint64 hash = 14695981039346656037ull;
+
+	uint8 buffer[Kilobytes(16)];
+	size_t bytesRead;
+	while ((bytesRead = fread(buffer, 1, sizeof(buffer), file)) > 0)
+	{
+		for (size_t i = 0; i < bytesRead; ++i)
+		{
+			hash = (hash ^ buffer[i]) * 1099511628211ull;
+		}
+	}
+
+	fclose(file);
+
+	return hash;
+}
+
+bool CachedAsset::open(const char *sourceFilename, CachedAssetType type, uint64 sourceHash)
+{
+	close();
+
+	char filename[MAX_CACHE_FILENAME_LENGTH];
+	if (sourceHash == 0 || !cacheFilename(sourceFilename, filename) || !file.open(filename))
+	{
+		return false;
+	}
+
+	const AssetCacheHeader *header = (const AssetCacheHeader *)file.data();
+	if (file.size() < sizeof(AssetCacheHeader) ||
+		header->magic != ASSET_CACHE_MAGIC ||
+		header->version != ASSET_CACHE_VERSION ||
+		header->type != (uint32)type ||
+		header->sourceHash != sourceHash ||
+		header->dataOffset + header->dataSize > file.size())
+	{
+		close();
+		return false;
+	}
+
+	memcpy(params, header->params, sizeof(params));
+	data = file.data() + header->dataOffset;
+	dataSize = header->dataSize;
+
+	return true;
+}
+
+void CachedAsset::close()
+{
+	file.close();
+	memset(params, 0, sizeof(params));
+	data = nullptr;
+	dataSize = 0;
+}
+
+bool CachedAsset::save(const char *sourceFilename, CachedAssetType type, uint64 sourceHash,
+	const uint32 params[MAX_PARAMS], const void *data, uint64 dataSize)
+{
+	char filename[MAX_CACHE_FILENAME_LENGTH];
+	if (sourceHash == 0 || !cacheFilename(sourceFilename, filename))
+	{
+		return false;
+	}
+
+	FILE *f = fopen(filename, "wb");
+	if (f == nullptr)
+	{
+		WLOG("CachedAsset::save() - could not open %s", filename);
+		return false;
+	}
+
+	AssetCacheHeader header = {};
+	header.magic = ASSET_CACHE_MAGIC;
+	header.version = ASSET_CACHE_VERSION;
+	header.type = (uint32)type;
+	header.sourceHash = sourceHash;
+	memcpy(header.params, params, sizeof(header.params));
+	header.dataOffset = (sizeof(header) + ASSET_CACHE_DATA_ALIGNMENT - 1) & ~(ASSET_CACHE_DATA_ALIGNMENT - 1);
+	header.dataSize = dataSize;
+
+	const uint8 zeros[ASSET_CACHE_DATA_ALIGNMENT] = {};
+	const size_t paddingSize = (size_t)(header.dataOffset - sizeof(header));
+
+	bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+	ok = ok && (paddingSize == 0 || fwrite(zeros, 1, paddingSize, f) == paddingSize);
+	ok = ok && fwrite(data, 1, (size_t)dataSize, f) == dataSize;
+
+	fclose(f);
+
+	if (!ok)
+	{
+		WLOG("CachedAsset::save() - could not write %s", filename);
+		remove(filename);
+	}
+
+	return ok;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+// NOTE: On-disk cache of decoded assets (RGBA8 pixels, PCM samples). Each
+// source file gets a "<filename>.cache" file next to it holding its decoded
+// data, tagged with a hash of the source contents. Later launches memory map
+// it and use the data in place, and a source that changed makes the cache
+// entry stale, so it is decoded and written again.
+
+enum class CachedAssetType : uint32
+{
+	Image = 1, // params: width, height
+	Sound = 2  // params: samplingRate, bitsPerSample, channelCount, sampleCount
+};
+
+// FNV-1a hash of the contents of a file, 0 if it can't be read
+uint64 hashFileContents(const char *filename);
+
+class CachedAsset
+{
+public:
+
+	static const uint32 MAX_PARAMS = 4;
+
+	// Maps the cache entry of a source file, fails if missing or stale
+	bool open(const char *sourceFilename, CachedAssetType type, uint64 sourceHash);
+
+	void close();
+
+	bool isOpen() const { return file.isOpen(); }
+
+	// Writes the cache entry of a source file
+	static bool save(const char *sourceFilename, CachedAssetType type, uint64 sourceHash,
+		const uint32 params[MAX_PARAMS], const void *data, uint64 dataSize);
+
+	uint32 params[MAX_PARAMS] = {};
+	const uint8 *data = nullptr; // Points into the mapped file
+	uint64 dataSize = 0;
+
+private:
+
+	MappedFile file;
+};
@@ -1,11 +1,35 @@
 #include "Networks.h"
 #include "Behaviours.h"
 
+const char *behaviourTypeName(BehaviourType type)
+{
+	switch (type)
+	{
+	case BehaviourType::None:                   return "None";
+	case BehaviourType::Player:                 return "Player";
+	case BehaviourType::Projectile:             return "Projectile";
+	case BehaviourType::DeathGhost:             return "DeathGhost";
+	case BehaviourType::Weapon:                 return "Weapon";
+	case BehaviourType::StaffProjectile:        return "StaffProjectile";
+	case BehaviourType::AxeProjectile:          return "AxeProjectile";
+	case BehaviourType::BowProjectile:          return "BowProjectile";
+	case BehaviourType::Spell:                  return "Spell";
+	case BehaviourType::AxeSpell:               return "AxeSpell";
+	case BehaviourType::StaffSpell:             return "StaffSpell";
+	case BehaviourType::BowSpell:               return "BowSpell";
+	case BehaviourType::WhirlwindAxeProjectile: return "WhirlwindAxeProjectile";
+	default:                                    return "Unknown";
+	}
+}
+
 void Player::start()
 {
 	gameObject->tag = (uint32)(Random.next() * UINT_MAX);
 
+	App->modBehaviour->updatePlayerRanking(this);
+
 	lifebar = Instantiate();
+	lifebar->setParent(gameObject, vec2{ -50.0f, -50.0f });
 	lifebar->sprite = App->modRender->addSprite(lifebar);
 	lifebar->sprite->pivot = vec2{ 0.0f, 0.5f };
 	lifebar->sprite->order = 5;
@@ -14,6 +38,7 @@ void Player::start()
 	if (isServer)
 	{
 		weapon = NetworkInstantiate();
+		weapon->setParent(gameObject, vec2{ 0.0f, 8.0f });
 		Weapon* wBehaviour = App->modBehaviour->addWeapon(weapon);
 		weapon->sprite = App->modRender->addSprite(weapon);
 
@@ -23,19 +48,19 @@ void Player::start()
 			weapon->sprite->texture = App->modResources->axe;
 			wBehaviour->weaponType = WeaponType::Axe;
 			weapon->sprite->pivot = vec2{ 0.5f, 0.0f };
-			weapon->size = vec2{ 50, 75 };
+			weapon->size() = vec2{ 50, 75 };
 			break;
 		case PlayerType::Wizard:
 			weapon->sprite->texture = App->modResources->staff;
 			wBehaviour->weaponType = WeaponType::Staff;
 			weapon->sprite->pivot = vec2{ 0.5f, 0.3f };
-			weapon->size = vec2{ 50, 100 };
+			weapon->size() = vec2{ 50, 100 };
 			break;
 		case PlayerType::Hunter:
 			weapon->sprite->texture = App->modResources->bow;
 			wBehaviour->weaponType = WeaponType::Bow;
 			weapon->sprite->pivot = vec2{ 0.5f, 0.2f };
-			weapon->size = vec2{ 100, 50 };
+			weapon->size() = vec2{ 100, 50 };
 			break;
 		case PlayerType::None:
 			break;
@@ -71,6 +96,11 @@ void Player::start()
 	}
 }
 
+void Player::destroy()
+{
+	App->modBehaviour->removePlayerRanking(this);
+}
+
 void Player::onInput(const InputController &input)
 {
 	if (currentState == PlayerState::Dead)
@@ -102,8 +132,7 @@ void Player::update()
 	static const vec4 colorDead = vec4{ 1.0f, 0.2f, 0.1f, 0.5f };
 
 	const float lifeRatio = max(0.01f, (float)(hitPoints) / (maxHitPoints));
-	lifebar->position = gameObject->position + vec2{ -50.0f, -50.0f };
-	lifebar->size = vec2{ lifeRatio * 80.0f, 5.0f };
+	lifebar->size() = vec2{ lifeRatio * 80.0f, 5.0f };
 	lifebar->sprite->color = lerp(colorDead, colorAlive, lifeRatio);
 
 
@@ -121,11 +150,6 @@ void Player::update()
 	}
 }
 
-void Player::destroy()
-{
-	Destroy(lifebar);
-}
-
 void Player::onCollisionTriggered(Collider& c1, Collider& c2)
 {
 	if (c2.type == ColliderType::Projectile && c2.gameObject->tag != gameObject->tag && !c2.gameObject->toBeDestroyed)
@@ -179,11 +203,11 @@ void Player::HandleMovementInput(const InputController& input)
 
 	if (!isZero(movement_vector))
 	{
-		gameObject->position += movement_vector * movementSpeed * Time.deltaTime;
+		gameObject->position() += movement_vector * movementSpeed * Time.deltaTime;
 
 		ChangeState(PlayerState::Running);
 		if (movement_vector.x != 0) //Flip character according to direction
-			gameObject->size.x = movement_vector.x > 0 ? abs(gameObject->size.x): -abs(gameObject->size.x);
+			gameObject->size().x = movement_vector.x > 0 ? abs(gameObject->size().x): -abs(gameObject->size().x);
 		
 		if (isServer)
 		{
@@ -226,32 +250,20 @@ void Player::UseSpell()
 
 void Player::Die()
 {
-	// Centered death effect
-	float size = gameObject->size.y;
-	vec2 position = gameObject->position;
-
-	GameObject* deathEffect = NetworkInstantiate();
-	deathEffect->position = deathEffect->initial_position = position;
-	deathEffect->size = vec2{ size, size };
-
-	deathEffect->sprite = App->modRender->addSprite(deathEffect);
-	deathEffect->sprite->texture = App->modResources->death;
-	deathEffect->sprite->order = 100;
-
-	deathEffect->animation = App->modRender->addAnimation(deathEffect);
-	deathEffect->animation->clip = App->modResources->deathClip;
-
-	DeathGhost* ghost_behav = App->modBehaviour->addDeathGhost(deathEffect);
-	deathEffect->behaviour = ghost_behav;
-	deathEffect->behaviour->isServer = isServer;
-
-	NetworkDestroy(deathEffect, 2.0f);
+	// Centered death effect, played locally by everyone
+	GameEvent deathEvent;
+	deathEvent.type = GameEventType::DeathEffect;
+	deathEvent.networkId = gameObject->networkId;
+	deathEvent.position = gameObject->position();
+	deathEvent.size = gameObject->size().y;
+	NetworkEvent(deathEvent, true);
 
 	//Kill player
 	level = BASE_LEVEL;
+	App->modBehaviour->updatePlayerRanking(this);
 	gameObject->collider->enabled = false;
 	gameObject->sprite->enabled = false;
-	gameObject->position = 1000.0f * vec2{ Random.next() - 0.5f, Random.next() - 0.5f };
+	gameObject->position() = 1000.0f * vec2{ Random.next() - 0.5f, Random.next() - 0.5f };
 	if (weapon)
 	{
 		weapon->sprite->enabled = false;
@@ -270,13 +282,13 @@ void Player::Respawn()
 
 	hitPoints = BASE_HP;
 	maxHitPoints = BASE_HP;
-	gameObject->size = { BASE_SIZE, BASE_SIZE };
+	gameObject->size() = { BASE_SIZE, BASE_SIZE };
 	movementSpeed = BASE_SPEED;
 
 	if (weapon)
 	{
 		Weapon* weaponBehaviour = (Weapon*)weapon->behaviour;
-		weapon->size = vec2{ weaponBehaviour->initial_size.x, weaponBehaviour->initial_size.y };
+		weapon->size() = vec2{ weaponBehaviour->initial_size.x, weaponBehaviour->initial_size.y };
 		weapon->sprite->enabled = true;
 
 		NetworkUpdate(weapon);
@@ -289,6 +301,7 @@ void Player::LevelUp(uint8 killedLevel)
 {
 	uint8 newLevel = min(level + 1, MAX_LEVEL);
 	level = max(killedLevel, newLevel);
+	App->modBehaviour->updatePlayerRanking(this);
 
 	uint8 newMaxHP = HitPoints(level);
 	float currentHPPercentage = (float)hitPoints / (float)maxHitPoints;
@@ -296,7 +309,7 @@ void Player::LevelUp(uint8 killedLevel)
 	maxHitPoints = newMaxHP;
 
 	float newSize = LevelSize(level, BASE_SIZE);
-	gameObject->size = vec2{ gameObject->size.x > 0 ? newSize : -newSize, newSize };
+	gameObject->size() = vec2{ gameObject->size().x > 0 ? newSize : -newSize, newSize };
 
 	movementSpeed = LevelSpeed(level);
 
@@ -305,7 +318,7 @@ void Player::LevelUp(uint8 killedLevel)
 		Weapon* weaponBehaviour = (Weapon*)weapon->behaviour;
 		float size_x = LevelSize(level, weaponBehaviour->initial_size.x);
 		float size_y = LevelSize(level, weaponBehaviour->initial_size.y);
-		weapon->size = vec2{ size_x, size_y };
+		weapon->size() = vec2{ size_x, size_y };
 
 		NetworkUpdate(weapon);
 	}
@@ -407,8 +420,8 @@ void Player::writeCreate(OutputMemoryStream& packet)
 	packet << movementSpeed;
 	packet << level;
 	packet << name;
-	packet << gameObject->position.x;
-	packet << gameObject->position.y;
+	packet << gameObject->position().x;
+	packet << gameObject->position().y;
 	packet << (weapon? weapon->networkId : 0);
 }
 
@@ -423,8 +436,8 @@ void Player::readCreate(const InputMemoryStream& packet)
 	packet >> movementSpeed;
 	packet >> level;
 	packet >> name;
-	packet >> gameObject->initial_position.x;
-	packet >> gameObject->initial_position.y;
+	packet >> gameObject->initial_position().x;
+	packet >> gameObject->initial_position().y;
 
 	uint32 weaponNetworkID;
 	packet >> weaponNetworkID;
@@ -459,15 +472,16 @@ void Player::readUpdate(const InputMemoryStream& packet)
 	packet >> hitPoints;
 	packet >> maxHitPoints;
 	packet >> movementSpeed;
-	packet >> level;
 
-	ChangeState(new_state);
-}
+	uint8 new_level;
+	packet >> new_level;
+	if (new_level != level)
+	{
+		level = new_level;
+		App->modBehaviour->updatePlayerRanking(this);
+	}
 
-void Player::GetChildrenNetworkObjects(std::list<GameObject*>& networkChildren)
-{
-	networkChildren.push_back(weapon);
-	spell->GetChildrenNetworkObjects(networkChildren);
+	ChangeState(new_state);
 }
 
 void Player::OnInterpolationDisable()
@@ -478,7 +492,7 @@ void Player::OnInterpolationDisable()
 
 void Projectile::start()
 {
-	gameObject->networkInterpolationEnabled = true;
+	gameObject->networkInterpolationEnabled = !IsKinematic();
 }
 
 void Projectile::update()
@@ -501,14 +515,56 @@ void Projectile::update()
 	}
 }
 
+void Projectile::UpdateKinematic()
+{
+	if (isServer || isFake)
+		Projectile::update();
+	else
+		secondsSinceCreation += Time.deltaTime;
+
+	gameObject->position() = gameObject->initial_position() + direction * velocity * secondsSinceCreation;
+}
+
 void Projectile::writeCreate(OutputMemoryStream& packet)
 {
 	packet << shooterID;
+
+	if (IsKinematic())
+	{
+		packet << direction.x;
+		packet << direction.y;
+		packet << velocity;
+		packet << secondsSinceCreation;
+	}
 }
 
 void Projectile::readCreate(const InputMemoryStream& packet)
 {
 	packet >> shooterID;
+
+	if (IsKinematic())
+	{
+		packet >> direction.x;
+		packet >> direction.y;
+		packet >> velocity;
+		packet >> secondsSinceCreation;
+
+		// No updates will come to interpolate, the motion is simulated here
+		gameObject->networkInterpolationEnabled = false;
+		gameObject->position() = gameObject->initial_position() + direction * velocity * secondsSinceCreation;
+	}
+}
+
+void Projectile::onCreateResent(const Behaviour &resent)
+{
+	if (!IsKinematic() || resent.type() != type()) return;
+
+	const Projectile &projectile = (const Projectile &)resent;
+	gameObject->initial_position() = projectile.gameObject->initial_position();
+	direction = projectile.direction;
+	velocity = projectile.velocity;
+	secondsSinceCreation = projectile.secondsSinceCreation;
+	gameObject->position() = gameObject->initial_position() + direction * velocity * secondsSinceCreation;
 }
 
 void AxeProjectile::start()
@@ -518,15 +574,9 @@ void AxeProjectile::start()
 
 void AxeProjectile::update()
 {
-	if (isServer || isFake) {
-		Projectile::update();
-
-		gameObject->angle += angleIncrementRatio;
-		gameObject->position += direction * velocity * Time.deltaTime;
+	UpdateKinematic();
 
-		if(isServer)
-			NetworkUpdate(gameObject);
-	}
+	gameObject->angle() += angleIncrementRatio;
 }
 
 void StaffProjectile::start()
@@ -536,14 +586,7 @@ void StaffProjectile::start()
 
 void StaffProjectile::update()
 {
-	if (isServer || isFake) {
-		Projectile::update();
-
-		gameObject->position += direction * velocity * Time.deltaTime;
-		
-		if (isServer)
-			NetworkUpdate(gameObject);
-	}
+	UpdateKinematic();
 }
 
 
@@ -554,27 +597,17 @@ void BowProjectile::start()
 
 void BowProjectile::update()
 {
-	if (isServer || isFake) {
-		Projectile::update();
-
-		gameObject->position += direction * velocity * Time.deltaTime;
-
-		if (isServer)
-			NetworkUpdate(gameObject);
-	}
+	UpdateKinematic();
 }
 
 
 void Weapon::start()
 {
-	initial_size = gameObject->size;
+	initial_size = gameObject->size();
 }
 
 void Weapon::update()
 {
-	vec2 offset = { 0, 8 };
-	gameObject->position = player->position + offset;
-
 	cooldownTimer += Time.deltaTime;
 }
 
@@ -591,15 +624,15 @@ void Weapon::Use()
 		projectile = Instantiate();
 	}
 
-	projectile->position = projectile->initial_position = gameObject->position;
+	projectile->position() = projectile->initial_position() = gameObject->position();
 
 	vec2 standardSize = { 75, 75 };
 	Player* playerBehaviour = (Player*)player->behaviour;
 	float sizeX = playerBehaviour->LevelSize(playerBehaviour->level, standardSize.x);
 	float sizeY = playerBehaviour->LevelSize(playerBehaviour->level, standardSize.y);
-	projectile->size = { sizeX, sizeY };
+	projectile->size() = { sizeX, sizeY };
 
-	projectile->angle = gameObject->angle;
+	projectile->angle() = gameObject->angle();
 	projectile->tag = gameObject->tag;
 
 	projectile->sprite = App->modRender->addSprite(projectile);
@@ -636,7 +669,7 @@ void Weapon::Use()
 	projectileBehaviour->isServer = isServer;
 	projectileBehaviour->shooterID = player->networkId;
 
-	projectileBehaviour->direction = vec2FromDegrees(gameObject->angle);
+	projectileBehaviour->direction = vec2FromDegrees(gameObject->angle());
 	projectileBehaviour->direction = { -projectileBehaviour->direction.x, -projectileBehaviour->direction.y };
 }
 
@@ -673,9 +706,9 @@ void Weapon::HandleWeaponRotation(const MouseController& input)
 {
 	vec2 mousePosition = { input.x, input.y };
 
-	float angle = atan2(mousePosition.y - gameObject->position.y, mousePosition.x - gameObject->position.x) * (180 / PI) - 90;
+	float angle = atan2(mousePosition.y - gameObject->position().y, mousePosition.x - gameObject->position().x) * (180 / PI) - 90;
 
-	gameObject->angle = angle;
+	gameObject->angle() = angle;
 
 	if (angle <= -115 && angle >= -245) {
 		gameObject->sprite->order = 1;
@@ -696,7 +729,7 @@ void DeathGhost::start()
 void DeathGhost::update()
 {
 	const float advanceSpeed = 50.0f;
-	gameObject->position.y -= advanceSpeed * Time.deltaTime;
+	gameObject->position().y -= advanceSpeed * Time.deltaTime;
 	gameObject->sprite->color.a -= 0.5f * Time.deltaTime;
 }
 
@@ -738,14 +771,6 @@ void AxeSpell::update()
 	}
 }
 
-void AxeSpell::GetChildrenNetworkObjects(std::list<GameObject*>& networkChildren)
-{
-	for (int i = 0; i < NUM_AXES; ++i) {
-		if(axes[i] != nullptr)
-			networkChildren.push_back(axes[i]);
-	}
-}
-
 void AxeSpell::Use()
 {
 	Spell::Use();
@@ -764,6 +789,7 @@ void AxeSpell::Use()
 		for (int i = 0; i < NUM_AXES; ++i) {
 
 			axes[i] = NetworkInstantiate();
+			axes[i]->setParent(gameObject);
 			axes[i]->sprite = App->modRender->addSprite(axes[i]);
 			axes[i]->sprite->order = 3;
 
@@ -777,7 +803,12 @@ void AxeSpell::Use()
 			whirlwindAxeBehaviour->orbitSpeed = newOrbitSpeed;
 			whirlwindAxeBehaviour->damagePoints = player->level;
 
-			axes[i]->size = { sizeX, sizeY };
+			// NOTE: Set here and not in start(), the create can be captured
+			// for replication before the behaviours are started
+			whirlwindAxeBehaviour->orbitAngle = PI / 2 + i * 2 * PI / NUM_AXES;
+			axes[i]->localPosition() = { newRotationRadius * cos(whirlwindAxeBehaviour->orbitAngle), newRotationRadius * sin(whirlwindAxeBehaviour->orbitAngle) };
+
+			axes[i]->size() = { sizeX, sizeY };
 			axes[i]->tag = gameObject->tag;
 		}
 	}
@@ -803,10 +834,11 @@ void AxeSpell::OnLevelUp()
 
 		for (int i = 0; i < NUM_AXES; ++i) {
 			if (axes[i]) {
-				axes[i]->size = { sizeX, sizeY };
+				axes[i]->size() = { sizeX, sizeY };
 				((WhirlwindAxeProjectile*)axes[i]->behaviour)->rotationRadius = newRotationRadius;
 				((WhirlwindAxeProjectile*)axes[i]->behaviour)->orbitSpeed = newOrbitSpeed;
 				((WhirlwindAxeProjectile*)axes[i]->behaviour)->damagePoints = player->level;
+				NetworkUpdate(axes[i]);
 			}
 		}
 	}
@@ -859,11 +891,11 @@ void StaffSpell::Use()
 			projectile->shooterID = gameObject->networkId;
 			projectile->player = player;
 			projectile->direction = vec2FromDegrees(angle);
-			projectile->gameObject->position = gameObject->position;
-			projectile->gameObject->initial_position = gameObject->position;
+			projectile->gameObject->position() = gameObject->position();
+			projectile->gameObject->initial_position() = gameObject->position();
 			angle += 45;
 
-			orbs[i]->size = { sizeX, sizeY };
+			orbs[i]->size() = { sizeX, sizeY };
 			orbs[i]->tag = gameObject->tag;
 		}
 	}
@@ -901,9 +933,9 @@ void BowSpell::Use()
 		float newSize = 90;
 
 		chargeEffect = NetworkInstantiate();
-		chargeEffect->position = chargeEffect->initial_position = vec2{ gameObject->position.x - offset.x, gameObject->position.y - offset.y };
+		chargeEffect->setParent(gameObject, vec2{ -offset.x, -offset.y });
 		newSize = player->LevelSize(player->level, newSize);
-		chargeEffect->size = vec2{ newSize, newSize };
+		chargeEffect->size() = vec2{ newSize, newSize };
 
 		chargeEffect->sprite = App->modRender->addSprite(chargeEffect);
 		chargeEffect->sprite->texture = App->modResources->chargeEffect;
@@ -945,11 +977,11 @@ void BowSpell::Release()
 	vec2 standardSize = { 20, 75 };
 	float sizeX = player->LevelSize(player->level, standardSize.x);
 	float sizeY = player->LevelSize(player->level, standardSize.y);
-	projectile->size = { sizeX, sizeY};
+	projectile->size() = { sizeX, sizeY};
 	projectile->tag = gameObject->tag;
 
-	projectile->position = projectile->initial_position = player->weapon->position;
-	projectile->angle = player->weapon->angle;
+	projectile->position() = projectile->initial_position() = player->weapon->position();
+	projectile->angle() = player->weapon->angle();
 
 	BowProjectile* projectileBehaviour = (BowProjectile*) App->modBehaviour->addProjectile(BehaviourType::BowProjectile, projectile);
 
@@ -959,7 +991,7 @@ void BowSpell::Release()
 	projectileBehaviour->isServer = isServer;
 	projectileBehaviour->shooterID = gameObject->networkId;
 
-	projectileBehaviour->direction = vec2FromDegrees(player->weapon->angle);
+	projectileBehaviour->direction = vec2FromDegrees(player->weapon->angle());
 	projectileBehaviour->direction = { -projectileBehaviour->direction.x, -projectileBehaviour->direction.y };
 
 	chargeTime = min(MAX_CHARGE, chargeTime);
@@ -1004,69 +1036,74 @@ void BowSpell::OnDeath()
 void WhirlwindAxeProjectile::start()
 {
 	Projectile::start();
+	gameObject->networkInterpolationEnabled = false;
 	lifetimeSeconds = 8.0f;
 	perforates = true;
-
-	if (isServer || (!isServer && shooterID == App->modNetClient->GetNetworkId())) {
-		if (index == 0)
-			orbitAngle = PI / 2;
-		else if(index == 1)
-			orbitAngle = 7 * PI / 6;
-		else{
-			orbitAngle = 11 * PI / 6;
-		}
-	}
 }
 
 void WhirlwindAxeProjectile::update()
 {
 	if (isServer) {
 		Projectile::update();
+	}
 
-		if (index == 0) {
-			gameObject->angle += selfRotationIncrementRatio;
-			orbitAngle += orbitSpeed * Time.deltaTime;
-			gameObject->position = gameObject->initial_position = { player->gameObject->position.x + rotationRadius * cos(orbitAngle) ,
-				player->gameObject->position.y + rotationRadius * sin(orbitAngle) };
-		}
-		else if(index == 1){
-			gameObject->angle += selfRotationIncrementRatio;
-			orbitAngle += orbitSpeed * Time.deltaTime;
-			gameObject->position = gameObject->initial_position = { player->gameObject->position.x + rotationRadius * cos(orbitAngle) ,
-				player->gameObject->position.y + rotationRadius * sin(orbitAngle) };
-		}else{
-			gameObject->angle += selfRotationIncrementRatio;
-			orbitAngle += orbitSpeed * Time.deltaTime;
-			gameObject->position = gameObject->initial_position = { player->gameObject->position.x + rotationRadius * cos(orbitAngle) ,
-				player->gameObject->position.y + rotationRadius * sin(orbitAngle) };
-		}
+	UpdateOrbit();
+}
 
-		HandleDamageTimers();
-		NetworkUpdate(gameObject);
-	}
+void WhirlwindAxeProjectile::UpdateOrbit()
+{
+	gameObject->angle() += selfRotationIncrementRatio;
+	orbitAngle += orbitSpeed * Time.deltaTime;
+	gameObject->localPosition() = { rotationRadius * cos(orbitAngle), rotationRadius * sin(orbitAngle) };
 }
 
-bool WhirlwindAxeProjectile::CanDamagePlayer(GameObject* player)
+void WhirlwindAxeProjectile::writeCreate(OutputMemoryStream& packet)
 {
-	if (playersDamaged.size() > 0) {
-		if (playersDamaged[player->networkId]) {
-			return false;
-		}
-	}
+	Projectile::writeCreate(packet);
+	writeUpdate(packet);
+}
 
-	playersDamaged.emplace(player->networkId, secondsToDamageAgain);
-	return true;
+void WhirlwindAxeProjectile::readCreate(const InputMemoryStream& packet)
+{
+	Projectile::readCreate(packet);
+	readUpdate(packet);
+	gameObject->networkInterpolationEnabled = false;
 }
 
-void WhirlwindAxeProjectile::HandleDamageTimers()
+void WhirlwindAxeProjectile::writeUpdate(OutputMemoryStream& packet)
 {
-	std::unordered_map<uint32, float>::iterator it;
-	for (it = playersDamaged.begin(); it != playersDamaged.end();) {
-		it->second -= Time.deltaTime;
-		if (it->second <= 0)
-			it = playersDamaged.erase(it);
-		else {
-			++it;
+	packet << orbitAngle;
+	packet << orbitSpeed;
+	packet << rotationRadius;
+}
+
+void WhirlwindAxeProjectile::readUpdate(const InputMemoryStream& packet)
+{
+	packet >> orbitAngle;
+	packet >> orbitSpeed;
+	packet >> rotationRadius;
+}
+
+bool WhirlwindAxeProjectile::CanDamagePlayer(GameObject* player)
+{
+	// Slot to store the player in: its own one, or an expired one, or else
+	// the one that expires the soonest
+	DamagedPlayer* slot = &playersDamaged[0];
+	for (DamagedPlayer& damaged : playersDamaged)
+	{
+		if (damaged.networkId == player->networkId)
+		{
+			if (damaged.expirationTime > Time.time)
+				return false;
+			slot = &damaged;
+			break;
 		}
+
+		if (damaged.expirationTime < slot->expirationTime)
+			slot = &damaged;
 	}
+
+	slot->networkId = player->networkId;
+	slot->expirationTime = Time.time + secondsToDamageAgain;
+	return true;
 }
@@ -25,12 +25,13 @@ struct Behaviour
 
 	virtual void onCollisionTriggered(Collider &c1, Collider &c2) { }
 
-	virtual void GetChildrenNetworkObjects(std::list<GameObject*>&) { }
-
 	virtual void writeCreate(OutputMemoryStream &packet) { }
 
 	virtual void readCreate(const InputMemoryStream &packet) { }
 
+	// Create received again for an existing object, read into a temporary one
+	virtual void onCreateResent(const Behaviour &resent) { }
+
 	virtual void writeUpdate(OutputMemoryStream& packet) { }
 
 	virtual void readUpdate(const InputMemoryStream& packet) { }
@@ -56,6 +57,8 @@ enum class BehaviourType : uint8
 	WhirlwindAxeProjectile
 };
 
+const char *behaviourTypeName(BehaviourType type);
+
 enum class PlayerType : uint8
 {
 	Berserker,
@@ -112,14 +115,14 @@ struct Player : public Behaviour
 
 	void start() override;
 
+	void destroy() override;
+
 	void onInput(const InputController& input) override;
 
 	void onMouseInput(const MouseController& input) override;
 
 	void update() override;
 
-	void destroy() override;
-
 	void onCollisionTriggered(Collider& c1, Collider& c2) override;
 
 	void writeCreate(OutputMemoryStream& packet) override;
@@ -127,8 +130,6 @@ struct Player : public Behaviour
 	void writeUpdate(OutputMemoryStream& packet) override;
 	void readUpdate(const InputMemoryStream& packet) override;
 
-	void GetChildrenNetworkObjects(std::list<GameObject*>& networkChildren) override;
-
 	void OnInterpolationDisable() override;
 
 	PlayerState currentState = PlayerState::Idle;
@@ -196,8 +197,18 @@ struct Projectile : public Behaviour
 
 	virtual bool CanDamagePlayer(GameObject* player) { return true; }
 
+	// NOTE: Kinematic projectiles move in a straight line from their spawn
+	// position, so they are only replicated on creation (spawn parameters
+	// and age) and destruction, and the clients simulate the motion.
+	// The age is the one at capture time, with no compensation for the
+	// one-way latency, so clients see them that much behind the server.
+	// Resent creates carry a fresher age, applied to the existing object.
+	virtual bool IsKinematic() const { return false; }
+	void UpdateKinematic();
+
 	void writeCreate(OutputMemoryStream& packet) override;
 	void readCreate(const InputMemoryStream& packet) override;
+	void onCreateResent(const Behaviour &resent) override;
 };
 
 struct AxeProjectile : public Projectile
@@ -206,6 +217,8 @@ struct AxeProjectile : public Projectile
 
 	BehaviourType type() const override { return BehaviourType::AxeProjectile; }
 
+	bool IsKinematic() const override { return true; }
+
 	void start() override;
 
 	void update() override;
@@ -216,8 +229,16 @@ struct WhirlwindAxeProjectile : public Projectile
 	float selfRotationIncrementRatio = 15;
 	float orbitAngle = 0;
 	float orbitSpeed = 1;
-	std::unordered_map<uint32, float> playersDamaged;
 	float secondsToDamageAgain = 2.0f;
+
+	// NOTE: Players hit recently, with the time they can be hit again.
+	// Expired entries are just reused, nothing to update per frame.
+	struct DamagedPlayer
+	{
+		uint32 networkId = 0;
+		double expirationTime = 0.0;
+	};
+	DamagedPlayer playersDamaged[MAX_CLIENTS];
 	float rotationRadius = 150;
 
 	uint8 index = 0;
@@ -230,13 +251,23 @@ struct WhirlwindAxeProjectile : public Projectile
 
 	bool CanDamagePlayer(GameObject* player) override;
 
-	void HandleDamageTimers();
+	// NOTE: The axe is a child of the shooter. The orbit is replicated as
+	// parameters (orbit phase, speed and radius), sent on creation and when
+	// they change, and the clients move the axe around it every frame
+	void UpdateOrbit();
+
+	void writeCreate(OutputMemoryStream& packet) override;
+	void readCreate(const InputMemoryStream& packet) override;
+	void writeUpdate(OutputMemoryStream& packet) override;
+	void readUpdate(const InputMemoryStream& packet) override;
 };
 
 struct StaffProjectile : public Projectile
 {
 	BehaviourType type() const override { return BehaviourType::StaffProjectile; }
 
+	bool IsKinematic() const override { return true; }
+
 	void start() override;
 
 	void update() override;
@@ -247,6 +278,8 @@ struct BowProjectile : public Projectile
 
 	BehaviourType type() const override { return BehaviourType::BowProjectile; }
 
+	bool IsKinematic() const override { return true; }
+
 	void start() override;
 
 	void update() override;
@@ -284,7 +317,6 @@ struct AxeSpell : public Spell
 
 	void start() override;
 	void update() override;
-	void GetChildrenNetworkObjects(std::list<GameObject*>& networkChildren) override;
 
 	virtual void Use();
 
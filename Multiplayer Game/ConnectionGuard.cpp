@@ -0,0 +1,110 @@
+#include "Networks.h"
+#include "ConnectionGuard.h"
+
+// Finalizer of splitmix64, every input bit affects every output bit
+static uint64 mix64(uint64 x)
+{
+	x ^= x >> 30;
+	x *= 0xbf58476d1ce4e5b9ull;
+	x ^= x >> 27;
+	x *= 0x94d049bb133111ebull;
+	x ^= x >> 31;
+	return x;
+}
+
+static uint64 addressKey(const sockaddr_in &address)
+{
+	return ((uint64)address.sin_addr.S_un.S_addr << 16) | (uint64)address.sin_port;
+}
+
+
+//////////////////////////////////////////////////////////////////////
+// ChallengeCookies
+//////////////////////////////////////////////////////////////////////
+
+void ChallengeCookies::reset()
+{
+	std::random_device device;
+	for (uint64 &word : secret)
+	{
+		word = ((uint64)device() << 32) ^ (uint64)device();
+	}
+}
+
+uint64 ChallengeCookies::generate(const sockaddr_in &address, double time) const
+{
+	return generate(address, (uint64)(time / SLOT_SECONDS));
+}
+
+bool ChallengeCookies::validate(uint64 cookie, const sockaddr_in &address, double time) const
+{
+	if (cookie == 0) return false;
+
+	// NOTE: The previous slot too, for cookies issued right before it ended
+	const uint64 slot = (uint64)(time / SLOT_SECONDS);
+	return cookie == generate(address, slot) || (slot > 0 && cookie == generate(address, slot - 1));
+}
+
+uint64 ChallengeCookies::generate(const sockaddr_in &address, uint64 slot) const
+{
+	uint64 hash = mix64(secret[0] ^ addressKey(address));
+	hash = mix64(hash ^ slot);
+	hash = mix64(hash ^ secret[1]);
+	return (hash != 0) ? hash : 1; // 0 means no cookie
+}
+
+
+//////////////////////////////////////////////////////////////////////
+// RateLimiter
+//////////////////////////////////////////////////////////////////////
+
+bool RateLimiter::allow(const sockaddr_in &address, double time)
+{
+	const uint32 ip = address.sin_addr.S_un.S_addr;
+	const uint16 port = address.sin_port;
+	const uint32 start = (uint32)(mix64(addressKey(address)) % MAX_SOURCES);
+
+	// Find the source, or a free or the stalest slot among the probed ones
+	Source *replaced = nullptr;
+	for (uint32 probe = 0; probe < MAX_PROBES; ++probe)
+	{
+		Source &source = sources[(start + probe) % MAX_SOURCES];
+		if (source.used && source.ip == ip && source.port == port)
+		{
+			const float elapsed = (float)(time - source.lastTime);
+			source.tokens = min(source.tokens + elapsed * packetsPerSecond, burstPackets);
+			source.lastTime = time;
+
+			if (source.tokens < 1.0f)
+			{
+				packetsDropped++;
+				return false;
+			}
+			source.tokens -= 1.0f;
+			return true;
+		}
+
+		if (replaced == nullptr || !source.used || (replaced->used && source.lastTime < replaced->lastTime))
+		{
+			replaced = &source;
+		}
+	}
+
+	// NOTE: New sources start with a full bucket, so evicting one under
+	// pressure never blocks it, it just forgets its past traffic
+	replaced->used = true;
+	replaced->ip = ip;
+	replaced->port = port;
+	replaced->tokens = burstPackets - 1.0f;
+	replaced->lastTime = time;
+	return true;
+}
+
+void RateLimiter::clear()
+{
+	for (Source &source : sources)
+	{
+		source = Source();
+	}
+	packetsDropped = 0;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+// NOTE: Server protections against unverified or abusive senders.
+// - Challenge cookies: a client must echo back a cookie derived from its
+//   address, the current time slot and a secret, proving it receives at
+//   that address, before the server allocates anything for it. Nothing is
+//   stored per cookie, validating one is just recomputing the hash. It is
+//   a keyed mix, not a cryptographic MAC, enough to stop blind spoofing.
+// - Rate limiter: a token bucket per source address, in a fixed table, so
+//   floods are dropped before parsing the packets.
+
+class ChallengeCookies
+{
+public:
+
+	static constexpr double SLOT_SECONDS = 10.0; // Cookies last one or two slots
+
+	// Picks a new secret, invalidating all the previous cookies
+	void reset();
+
+	uint64 generate(const sockaddr_in &address, double time) const;
+	bool validate(uint64 cookie, const sockaddr_in &address, double time) const;
+
+private:
+
+	uint64 generate(const sockaddr_in &address, uint64 slot) const;
+
+	uint64 secret[2] = {};
+};
+
+class RateLimiter
+{
+public:
+
+	static const int MAX_SOURCES = 1024;
+	static const int MAX_PROBES = 8;
+
+	float packetsPerSecond = 60.0f;
+	float burstPackets = 120.0f;
+
+	// False if the source has exceeded its rate
+	bool allow(const sockaddr_in &address, double time);
+
+	void clear();
+
+	uint32 packetsDropped = 0;
+
+private:
+
+	struct Source
+	{
+		bool used = false;
+		uint32 ip = 0;
+		uint16 port = 0;
+		float tokens = 0.0f;
+		double lastTime = 0.0;
+	};
+
+	Source sources[MAX_SOURCES];
+};
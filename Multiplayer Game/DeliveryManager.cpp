@@ -52,6 +52,12 @@ void DeliveryManager::processAckdSequenceNumbers(const InputMemoryStream& packet
 		{
 			if ((*it)->sequenceNumber == sequenceNumber)
 			{
+				if (stats != nullptr)
+				{
+					stats->deliveriesAcked.fetch_add(1, std::memory_order_relaxed);
+					stats->rtt.addSample(Time.time - (*it)->dispatchTime);
+				}
+
 				(*it)->delegate->onDeliverySuccess(this);
 				delete (*it)->delegate;
 				delete* it;
@@ -69,6 +75,11 @@ void DeliveryManager::processTimedOutPackets()
 	{
 		if (Time.time - (*it)->dispatchTime >= PACKET_DELIVERY_TIMEOUT_SECONDS)
 		{
+			if (stats != nullptr)
+			{
+				stats->deliveriesResent.fetch_add(1, std::memory_order_relaxed);
+			}
+
 			(*it)->delegate->onDeliveryFailure(this);
 			delete (*it)->delegate;
 			delete* it;
@@ -91,9 +102,11 @@ void DeliveryManager::clear()
 
 	nextExpectedSequenceNumber = 0;
 	pendingAckSequenceNumbers.clear();
+
+	stats = nullptr;
 }
 
-ReplicationDeliveryDelegate::ReplicationDeliveryDelegate(ReplicationManagerServer* repManager) :replicationManager(repManager)
+ReplicationDeliveryDelegate::ReplicationDeliveryDelegate(ReplicationManagerServer* repManager, MessageChannelSender* channels) :replicationManager(repManager), channels(channels)
 {
 	for (std::unordered_map<uint32, ReplicationCommand>::iterator it = replicationManager->commands.begin(); it != replicationManager->commands.end(); ++it)
 	{
@@ -121,3 +134,23 @@ void ReplicationDeliveryDelegate::repeatReplication()
 		}
 	}
 }
+
+void ReplicationDeliveryDelegate::acknowledgeChannelMessages()
+{
+	if (channels == nullptr) return;
+
+	for (const SentChannelMessage& sent : channelMessages)
+	{
+		channels->onDelivered(sent);
+	}
+}
+
+void ReplicationDeliveryDelegate::repeatChannelMessages()
+{
+	if (channels == nullptr) return;
+
+	for (const SentChannelMessage& sent : channelMessages)
+	{
+		channels->onLost(sent);
+	}
+}
@@ -17,22 +17,29 @@ class ReplicationDeliveryDelegate : public DeliveryDelegate
 {
 public:
 
-	ReplicationDeliveryDelegate(ReplicationManagerServer* repManager);
+	ReplicationDeliveryDelegate(ReplicationManagerServer* repManager, MessageChannelSender* channels = nullptr);
 
 	void onDeliverySuccess(DeliveryManager* deliverManager)
 	{
-
+		acknowledgeChannelMessages();
 	}
 	void onDeliveryFailure(DeliveryManager* deliverManager)
 	{
 		repeatReplication();
+		repeatChannelMessages();
 	}
 
+	// Reliable channel messages written into the packet
+	std::vector<SentChannelMessage> channelMessages;
+
 private:
 	void repeatReplication();
+	void acknowledgeChannelMessages();
+	void repeatChannelMessages();
 
 	std::vector<ReplicationCommand> commands;
 	ReplicationManagerServer* replicationManager = nullptr;
+	MessageChannelSender* channels = nullptr;
 };
 
 struct Delivery
@@ -66,6 +73,9 @@ public:
 
 	void clear();
 
+	// Optional, to count acks, resends and round trip times
+	ConnectionStats *stats = nullptr;
+
 private:
 
 	// Private members(sender side)
@@ -11,6 +11,7 @@ struct PS_INPUT
 {
 	float4 pos : SV_POSITION;
 	float2 uv  : TEXCOORD0;
+	float4 col : COLOR0;
 };
 
 sampler sampler0;
@@ -18,6 +19,6 @@ Texture2D texture0;
 
 float4 main(PS_INPUT input) : SV_Target
 {
-	float4 out_col = texture0.Sample(sampler0, input.uv) * TintColor;
+	float4 out_col = texture0.Sample(sampler0, input.uv) * input.col * TintColor;
 	return out_col;
 }
@@ -11,12 +11,14 @@ struct VS_INPUT
 {
 	float2 pos : POSITION;
 	float2 uv  : TEXCOORD0;
+	float4 col : COLOR0;
 };
 
 struct PS_INPUT
 {
 	float4 pos : SV_POSITION;
 	float2 uv  : TEXCOORD0;
+	float4 col : COLOR0;
 };
 
 PS_INPUT main(VS_INPUT input)
@@ -26,5 +28,6 @@ PS_INPUT main(VS_INPUT input)
 	output.pos = mul(ViewMatrix, output.pos);
 	output.pos = mul(ProjectionMatrix, output.pos);
 	output.uv  = input.uv;
+	output.col = input.col;
 	return output;
 }
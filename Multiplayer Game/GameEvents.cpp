@@ -0,0 +1,54 @@
+#include "Networks.h"
+#include "GameEvents.h"
+
+
+//////////////////////////////////////////////////////////////////////
+// Events
+//////////////////////////////////////////////////////////////////////
+
+void GameEvent::write(OutputMemoryStream &packet) const
+{
+	packet << type;
+	packet << networkId;
+	packet << position.x;
+	packet << position.y;
+	packet << size;
+}
+
+void GameEvent::read(const InputMemoryStream &packet)
+{
+	packet >> type;
+	packet >> networkId;
+	packet >> position.x;
+	packet >> position.y;
+	packet >> size;
+}
+
+void playGameEvent(const GameEvent &event)
+{
+	switch (event.type)
+	{
+	case GameEventType::DeathEffect:
+	{
+		GameObject *deathEffect = Instantiate();
+		deathEffect->position() = deathEffect->initial_position() = event.position;
+		deathEffect->size() = vec2{ event.size, event.size };
+
+		deathEffect->sprite = App->modRender->addSprite(deathEffect);
+		deathEffect->sprite->texture = App->modResources->death;
+		deathEffect->sprite->order = 100;
+
+		deathEffect->animation = App->modRender->addAnimation(deathEffect);
+		deathEffect->animation->clip = App->modResources->deathClip;
+
+		App->modBehaviour->addDeathGhost(deathEffect);
+
+		Destroy(deathEffect, 2.0f);
+		break;
+	}
+	default:
+		WLOG("playGameEvent() - unknown event type %u", (uint32)event.type);
+		break;
+	}
+}
+
@@ -0,0 +1,25 @@
+#pragma once
+
+// NOTE: One-shot gameplay events (death effects and the like) that the
+// server sends to the clients as channel messages. Both sides play them
+// as local game objects, so purely cosmetic effects don't take network
+// objects nor create/destroy commands.
+
+enum class GameEventType : uint8
+{
+	DeathEffect
+};
+
+struct GameEvent
+{
+	GameEventType type = GameEventType::DeathEffect;
+	uint32 networkId = 0; // Object the event refers to, if any
+	vec2 position = {};
+	float size = 0.0f;
+
+	void write(OutputMemoryStream &packet) const;
+	void read(const InputMemoryStream &packet);
+};
+
+// Plays the local effect of an event
+void playGameEvent(const GameEvent &event);
@@ -0,0 +1,437 @@
+#include "Networks.h"
+#include "Log.h"
+
+
+//////////////////////////////////////////////////////////////////////
+// Record queue
+//////////////////////////////////////////////////////////////////////
+
+// NOTE: Bounded multi-producer queue (Vyukov). Each record carries a
+// sequence number that tells whether it is free for the producer that
+// claims position p (sequence == p) or ready for the consumer
+// (sequence == p + 1). Only the log thread consumes.
+
+static_assert((MAX_LOG_RECORDS & (MAX_LOG_RECORDS - 1)) == 0, "MAX_LOG_RECORDS must be a power of two");
+
+static LogRecord logRecords[MAX_LOG_RECORDS];
+static std::atomic<uint32> logEnqueuePosition{ 0 };
+static uint32 logDequeuePosition = 0;
+static std::atomic<uint32> logDroppedCount{ 0 };
+
+static bool initLogRecords()
+{
+	for (uint32 i = 0; i < MAX_LOG_RECORDS; ++i)
+	{
+		logRecords[i].sequence.store(i, std::memory_order_relaxed);
+	}
+	return true;
+}
+
+static bool logRecordsInitialized = initLogRecords();
+
+LogRecord *beginLogRecord()
+{
+	uint32 position = logEnqueuePosition.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		LogRecord *record = &logRecords[position & (MAX_LOG_RECORDS - 1)];
+		const uint32 sequence = record->sequence.load(std::memory_order_acquire);
+		const int32 difference = (int32)(sequence - position);
+		if (difference == 0)
+		{
+			if (logEnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+			{
+				return record;
+			}
+		}
+		else if (difference < 0)
+		{
+			logDroppedCount.fetch_add(1, std::memory_order_relaxed);
+			return nullptr;
+		}
+		else
+		{
+			position = logEnqueuePosition.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+void endLogRecord(LogRecord *record)
+{
+	const uint32 position = record->sequence.load(std::memory_order_relaxed);
+	record->sequence.store(position + 1, std::memory_order_release);
+}
+
+static LogRecord *peekLogRecord()
+{
+	LogRecord *record = &logRecords[logDequeuePosition & (MAX_LOG_RECORDS - 1)];
+	const uint32 sequence = record->sequence.load(std::memory_order_acquire);
+	return (sequence == logDequeuePosition + 1) ? record : nullptr;
+}
+
+static void releaseLogRecord(LogRecord *record)
+{
+	record->sequence.store(logDequeuePosition + MAX_LOG_RECORDS, std::memory_order_release);
+	logDequeuePosition++;
+}
+
+
+//////////////////////////////////////////////////////////////////////
+// Formatting
+//////////////////////////////////////////////////////////////////////
+
+class LogArgReader
+{
+public:
+
+	explicit LogArgReader(const LogRecord *record) : record(record) { }
+
+	bool read(LogArgType &type, uint64 &value, const char *&string, uint16 &length)
+	{
+		if (offset >= record->argsSize) return false;
+		type = (LogArgType)record->args[offset++];
+		if (type == LogArgType::String)
+		{
+			memcpy(&length, record->args + offset, sizeof(length));
+			string = (const char *)record->args + offset + sizeof(length);
+			offset += sizeof(length) + length;
+		}
+		else
+		{
+			memcpy(&value, record->args + offset, sizeof(value));
+			offset += sizeof(value);
+		}
+		return true;
+	}
+
+private:
+
+	const LogRecord *record;
+	uint32 offset = 0;
+};
+
+static void appendToMessage(char *message, uint32 &length, const char *text, size_t textLength)
+{
+	const size_t available = MAX_LOG_ENTRY_LENGTH - 1 - length;
+	textLength = min(textLength, available);
+	memcpy(message + length, text, textLength);
+	length += (uint32)textLength;
+	message[length] = '\0';
+}
+
+static void formatLogRecord(const LogRecord *record, char *message)
+{
+	uint32 length = 0;
+	message[0] = '\0';
+
+	// Find base filename (without directories)
+	const char *basefile = record->file;
+	for (const char *c = record->file; *c != '\0'; ++c) {
+		if (*c == '\\' || *c == '/') {
+			basefile = c + 1;
+		}
+	}
+
+	char text[MAX_LOG_ENTRY_LENGTH];
+	int textLength = sprintf_s(text, sizeof(text), "%s(%d) : ", basefile, record->line);
+	appendToMessage(message, length, text, max(textLength, 0));
+
+	LogArgReader reader(record);
+	const char *f = record->format;
+	while (*f != '\0')
+	{
+		// Literal text up to the next conversion
+		const char *literal = f;
+		while (*f != '\0' && *f != '%') ++f;
+		appendToMessage(message, length, literal, f - literal);
+		if (*f == '\0') break;
+
+		if (f[1] == '%')
+		{
+			appendToMessage(message, length, "%", 1);
+			f += 2;
+			continue;
+		}
+
+		// Rebuild the conversion with the flags, width and precision, and
+		// the length modifier that matches how the argument was stored
+		char spec[32] = "%";
+		uint32 specLength = 1;
+		++f;
+		while (*f != '\0' && strchr("-+ #0123456789.*", *f) != nullptr && specLength < sizeof(spec) - 16)
+		{
+			if (*f == '*')
+			{
+				LogArgType type; uint64 value = 0; const char *string; uint16 stringLength;
+				int star = reader.read(type, value, string, stringLength) ? (int)(int64)value : 0;
+				specLength += sprintf_s(spec + specLength, sizeof(spec) - specLength, "%d", star);
+			}
+			else
+			{
+				spec[specLength++] = *f;
+			}
+			++f;
+		}
+		while (*f != '\0' && strchr("hlLzjtI0123456789", *f) != nullptr) ++f;
+		const char conversion = *f;
+		if (conversion == '\0') break;
+		++f;
+
+		LogArgType type;
+		uint64 value = 0;
+		const char *string = nullptr;
+		uint16 stringLength = 0;
+		if (!reader.read(type, value, string, stringLength))
+		{
+			appendToMessage(message, length, "(missing)", 9);
+			continue;
+		}
+
+		double storedDouble;
+		memcpy(&storedDouble, &value, sizeof(storedDouble));
+		const int64 asInt = (type == LogArgType::Double) ? (int64)storedDouble : (int64)value;
+		const double asDouble = (type == LogArgType::Double) ? storedDouble :
+			(type == LogArgType::Int) ? (double)(int64)value : (double)value;
+
+		switch (conversion)
+		{
+		case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+			spec[specLength++] = 'l';
+			spec[specLength++] = 'l';
+			spec[specLength++] = conversion;
+			spec[specLength] = '\0';
+			textLength = sprintf_s(text, sizeof(text), spec, asInt);
+			break;
+		case 'c':
+			spec[specLength++] = 'c';
+			spec[specLength] = '\0';
+			textLength = sprintf_s(text, sizeof(text), spec, (int)asInt);
+			break;
+		case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+			spec[specLength++] = conversion;
+			spec[specLength] = '\0';
+			textLength = sprintf_s(text, sizeof(text), spec, asDouble);
+			break;
+		case 's':
+			if (type == LogArgType::String)
+			{
+				char stringCopy[MAX_LOG_ARGS_SIZE];
+				memcpy(stringCopy, string, stringLength);
+				stringCopy[stringLength] = '\0';
+				spec[specLength++] = 's';
+				spec[specLength] = '\0';
+				textLength = sprintf_s(text, sizeof(text), spec, stringCopy);
+			}
+			else
+			{
+				// NOTE: A %s with anything but a string is a bug at the call
+				// site (e.g. a void* buffer not cast to const char*), and it
+				// must not go unnoticed as a quiet placeholder
+				textLength = sprintf_s(text, sizeof(text), "(%%s WITH A NON-STRING ARGUMENT)");
+			}
+			break;
+		case 'p':
+			textLength = sprintf_s(text, sizeof(text), "%p", (void*)(uintptr_t)value);
+			break;
+		default:
+			textLength = sprintf_s(text, sizeof(text), "(?)");
+			break;
+		}
+
+		appendToMessage(message, length, text, max(textLength, 0));
+	}
+
+	appendToMessage(message, length, "\n", 1);
+}
+
+
+//////////////////////////////////////////////////////////////////////
+// Log thread
+//////////////////////////////////////////////////////////////////////
+
+// History of formatted messages shown in the UI, written by the log thread
+static LogEntry logEntry[MAX_LOG_ENTRIES];
+static uint32 logEntryFront = 0;
+static uint32 logEntryBack = 0;
+static std::mutex logEntryMutex;
+
+static std::thread logThread;
+static std::atomic<bool> logThreadExit{ false };
+static FILE *logFile = nullptr;
+
+// The queue has a single consumer at a time: the log thread, or a thread
+// draining it synchronously (errors and crashes)
+static std::mutex logFlushMutex;
+static std::atomic<bool> logCrashing{ false };
+
+static void addLogEntry(double time, int type, const char *message)
+{
+	std::unique_lock<std::mutex> lock(logEntryMutex);
+
+	LogEntry &entry = logEntry[logEntryBack % MAX_LOG_ENTRIES];
+	entry.type = type;
+	entry.time = time;
+	strcpy_s(entry.message, MAX_LOG_ENTRY_LENGTH, message);
+
+	// Handle log size limit
+	logEntryBack++;
+	if (logEntryBack - logEntryFront > MAX_LOG_ENTRIES)
+		logEntryFront = logEntryBack - MAX_LOG_ENTRIES;
+}
+
+static void writeLogMessage(double time, int type, const char *message)
+{
+	// NOTE: The history is skipped while crashing, its lock may be taken
+	if (!logCrashing)
+	{
+		addLogEntry(time, type, message);
+	}
+
+	if (logFile != nullptr)
+	{
+		static const char *typeNames[] = { "INFO", "WARN", "ERROR", "DEBUG" };
+		fprintf(logFile, "%.4f %-5s %s", time, typeNames[type & 3], message);
+	}
+
+	// Windows debug output
+	OutputDebugString(message);
+}
+
+// Formats and writes all the records in the queue, returns how many.
+// Called with logFlushMutex taken.
+static uint32 flushLogRecords()
+{
+	static char message[MAX_LOG_ENTRY_LENGTH];
+
+	uint32 count = 0;
+	while (LogRecord *record = peekLogRecord())
+	{
+		const double time = record->time;
+		const int type = record->type;
+		formatLogRecord(record, message);
+		releaseLogRecord(record);
+
+		writeLogMessage(time, type, message);
+		count++;
+	}
+
+	const uint32 dropped = logDroppedCount.exchange(0, std::memory_order_relaxed);
+	if (dropped > 0)
+	{
+		sprintf_s(message, MAX_LOG_ENTRY_LENGTH, "Log queue full, %u messages dropped\n", dropped);
+		writeLogMessage(Time.time, LOG_TYPE_WARN, message);
+	}
+
+	if (count > 0 && logFile != nullptr)
+	{
+		fflush(logFile);
+	}
+
+	return count;
+}
+
+static void logThreadMain()
+{
+	while (!logThreadExit)
+	{
+		// NOTE: Producers don't signal anything, to keep logging lock-free,
+		// so the thread polls for records when the queue is empty
+		uint32 count;
+		{
+			std::unique_lock<std::mutex> lock(logFlushMutex);
+			count = flushLogRecords();
+		}
+		if (count == 0)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		}
+	}
+
+	flushLog();
+}
+
+static LONG WINAPI logCrashHandler(EXCEPTION_POINTERS *exception)
+{
+	flushLogOnCrash();
+	return EXCEPTION_CONTINUE_SEARCH;
+}
+
+bool startLogThread(const char *filename)
+{
+	ASSERT(!logThread.joinable());
+
+	logFile = fopen(filename, "w");
+	if (logFile == nullptr)
+	{
+		WLOG("Could not open log file %s", filename);
+	}
+
+	SetUnhandledExceptionFilter(logCrashHandler);
+
+	logThreadExit = false;
+	logThread = std::thread(logThreadMain);
+
+	return true;
+}
+
+void stopLogThread()
+{
+	if (logThread.joinable())
+	{
+		logThreadExit = true;
+		logThread.join();
+	}
+	else
+	{
+		flushLog();
+	}
+
+	if (logFile != nullptr)
+	{
+		fclose(logFile);
+		logFile = nullptr;
+	}
+}
+
+void flushLog()
+{
+	std::unique_lock<std::mutex> lock(logFlushMutex);
+	flushLogRecords();
+}
+
+void flushLogOnCrash()
+{
+	if (logCrashing.exchange(true)) return; // Crashed again while flushing
+
+	// NOTE: The crash may come from the thread that holds the lock (e.g.
+	// formatting a record), so it is only waited for a while
+	std::unique_lock<std::mutex> lock(logFlushMutex, std::defer_lock);
+	for (int attempt = 0; attempt < 100 && !lock.try_lock(); ++attempt)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	if (lock.owns_lock())
+	{
+		flushLogRecords();
+	}
+}
+
+uint32 getLogEntryCount()
+{
+	std::unique_lock<std::mutex> lock(logEntryMutex);
+	return logEntryBack - logEntryFront;
+}
+
+LogEntry getLogEntry(uint32 logLineIndex)
+{
+	std::unique_lock<std::mutex> lock(logEntryMutex);
+	ASSERT(logEntryFront + logLineIndex < logEntryBack);
+	return logEntry[(logEntryFront + logLineIndex) % MAX_LOG_ENTRIES];
+}
+
+void clearLogEntries()
+{
+	std::unique_lock<std::mutex> lock(logEntryMutex);
+	logEntryFront = 0;
+	logEntryBack = 0;
+}
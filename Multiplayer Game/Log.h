@@ -0,0 +1,125 @@
+#pragma once
+
+// NOTE: Deferred formatting. A log call stores the format pointer (a string
+// literal, so it stays valid) and its arguments in binary, each one tagged
+// with its type. Strings are copied, as they may not outlive the call.
+// The log thread formats the message later, walking the format string.
+
+enum class LogArgType : uint8
+{
+	Int,     // int64
+	UInt,    // uint64
+	Double,  // double
+	String,  // uint16 length + characters, without null terminator
+	Pointer  // uint64
+};
+
+struct LogRecord
+{
+	std::atomic<uint32> sequence{ 0 };
+	double time;
+	int type;
+	int line;
+	const char *file;
+	const char *format;
+	uint32 argsSize;
+	uint8 args[MAX_LOG_ARGS_SIZE];
+};
+
+// To reserve a record in the queue (nullptr if the queue is full) and to
+// publish it once filled. Safe to call from any thread.
+LogRecord *beginLogRecord();
+void endLogRecord(LogRecord *record);
+
+class LogArgWriter
+{
+public:
+
+	explicit LogArgWriter(LogRecord *record) : record(record) { }
+
+	void write(LogArgType type, const void *data, uint32 size)
+	{
+		if (record->argsSize + 1 + size > MAX_LOG_ARGS_SIZE) return; // Dropped, printed as missing
+		record->args[record->argsSize++] = (uint8)type;
+		memcpy(record->args + record->argsSize, data, size);
+		record->argsSize += size;
+	}
+
+	void write(int64 value)  { write(LogArgType::Int, &value, sizeof(value)); }
+	void write(uint64 value) { write(LogArgType::UInt, &value, sizeof(value)); }
+	void write(double value) { write(LogArgType::Double, &value, sizeof(value)); }
+
+	void writeString(const char *string)
+	{
+		if (string == nullptr) string = "(null)";
+		const uint32 available = MAX_LOG_ARGS_SIZE - record->argsSize;
+		if (available < 1 + sizeof(uint16)) return;
+		uint16 length = (uint16)min(strlen(string), (size_t)(available - 1 - sizeof(uint16)));
+		record->args[record->argsSize++] = (uint8)LogArgType::String;
+		memcpy(record->args + record->argsSize, &length, sizeof(length));
+		memcpy(record->args + record->argsSize + sizeof(length), string, length);
+		record->argsSize += sizeof(length) + length;
+	}
+
+	void writePointer(const void *pointer)
+	{
+		uint64 value = (uint64)(uintptr_t)pointer;
+		write(LogArgType::Pointer, &value, sizeof(value));
+	}
+
+private:
+
+	LogRecord *record;
+};
+
+// NOTE: One overload per argument type, so each one gets its right tag
+// (unscoped enums promote to int)
+inline void writeLogArg(LogArgWriter &w, bool v)               { w.write((int64)v); }
+inline void writeLogArg(LogArgWriter &w, char v)               { w.write((int64)v); }
+inline void writeLogArg(LogArgWriter &w, signed char v)        { w.write((int64)v); }
+inline void writeLogArg(LogArgWriter &w, unsigned char v)      { w.write((uint64)v); }
+inline void writeLogArg(LogArgWriter &w, short v)              { w.write((int64)v); }
+inline void writeLogArg(LogArgWriter &w, unsigned short v)     { w.write((uint64)v); }
+inline void writeLogArg(LogArgWriter &w, int v)                { w.write((int64)v); }
+inline void writeLogArg(LogArgWriter &w, unsigned int v)       { w.write((uint64)v); }
+inline void writeLogArg(LogArgWriter &w, long v)               { w.write((int64)v); }
+inline void writeLogArg(LogArgWriter &w, unsigned long v)      { w.write((uint64)v); }
+inline void writeLogArg(LogArgWriter &w, long long v)          { w.write((int64)v); }
+inline void writeLogArg(LogArgWriter &w, unsigned long long v) { w.write((uint64)v); }
+inline void writeLogArg(LogArgWriter &w, float v)              { w.write((double)v); }
+inline void writeLogArg(LogArgWriter &w, double v)             { w.write(v); }
+inline void writeLogArg(LogArgWriter &w, const char *v)        { w.writeString(v); }
+inline void writeLogArg(LogArgWriter &w, const void *v)        { w.writePointer(v); }
+
+inline void writeLogArgs(LogArgWriter &) { }
+
+template <typename T, typename... Args>
+inline void writeLogArgs(LogArgWriter &w, const T &arg, const Args &... args)
+{
+	writeLogArg(w, arg);
+	writeLogArgs(w, args...);
+}
+
+template <typename... Args>
+void log(const char file[], int line, int type, const char *format, const Args &... args)
+{
+	LogRecord *record = beginLogRecord();
+	if (record == nullptr) return; // Queue full, counted as dropped
+
+	record->time = Time.time;
+	record->type = type;
+	record->line = line;
+	record->file = file;
+	record->format = format;
+	record->argsSize = 0;
+
+	LogArgWriter writer(record);
+	writeLogArgs(writer, args...);
+
+	endLogRecord(record);
+
+	if (type == LOG_TYPE_ERROR)
+	{
+		flushLog();
+	}
+}
@@ -0,0 +1,65 @@
+#include "Networks.h"
+#include "MappedFile.h"
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+bool MappedFile::open(const char *filename)
+{
+	close();
+
+	fileHandle = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+	{
+		close();
+		return false;
+	}
+
+	mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mappingHandle == NULL)
+	{
+		close();
+		return false;
+	}
+
+	mappedData = (const uint8 *)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	if (mappedData == nullptr)
+	{
+		close();
+		return false;
+	}
+
+	mappedSize = (uint64)fileSize.QuadPart;
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (mappedData != nullptr)
+	{
+		UnmapViewOfFile(mappedData);
+		mappedData = nullptr;
+	}
+
+	if (mappingHandle != NULL)
+	{
+		CloseHandle(mappingHandle);
+		mappingHandle = NULL;
+	}
+
+	if (fileHandle != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(fileHandle);
+		fileHandle = INVALID_HANDLE_VALUE;
+	}
+
+	mappedSize = 0;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+// NOTE: Read-only memory mapping of a whole file. The contents are paged
+// in by the OS on demand, nothing is copied when opening the file.
+class MappedFile
+{
+public:
+
+	~MappedFile();
+
+	bool open(const char *filename);
+
+	void close();
+
+	bool isOpen() const { return mappedData != nullptr; }
+
+	const uint8 *data() const { return mappedData; }
+
+	uint64 size() const { return mappedSize; }
+
+private:
+
+	HANDLE fileHandle = INVALID_HANDLE_VALUE;
+	HANDLE mappingHandle = NULL;
+	const uint8 *mappedData = nullptr;
+	uint64 mappedSize = 0;
+};
@@ -0,0 +1,277 @@
+#include "Networks.h"
+#include "MessageChannels.h"
+
+static bool channelHasIds(ChannelType channel)
+{
+	return channel != ChannelType::Unreliable;
+}
+
+static bool channelIsReliable(ChannelType channel)
+{
+	return channel == ChannelType::ReliableUnordered || channel == ChannelType::ReliableOrdered;
+}
+
+
+//////////////////////////////////////////////////////////////////////
+// MessageChannelSender
+//////////////////////////////////////////////////////////////////////
+
+bool MessageChannelSender::send(ChannelType type, const OutputMemoryStream &message)
+{
+	ASSERT(message.GetSize() <= ChannelMessage::MAX_SIZE);
+
+	Channel &channel = channels[(int)type];
+	if (channel.count == WINDOW_SIZE)
+	{
+		WLOG("MessageChannelSender::send() - channel %u is full, message dropped", (uint32)type);
+		return false;
+	}
+
+	ChannelMessage &queued = channel.messages[channel.count++];
+	queued.id = channel.nextId++;
+	queued.size = (uint8)message.GetSize();
+	queued.inFlight = false;
+	memcpy(queued.data, message.GetBufferPtr(), queued.size);
+	return true;
+}
+
+void MessageChannelSender::write(OutputMemoryStream &packet, std::vector<SentChannelMessage> &sentMessages)
+{
+	uint32 budget = MAX_BYTES_PER_PACKET;
+
+	for (int c = 0; c < (int)ChannelType::Count; ++c)
+	{
+		Channel &channel = channels[c];
+		const ChannelType type = (ChannelType)c;
+		const uint32 headerSize = (channelHasIds(type) ? sizeof(uint16) : 0) + sizeof(uint8);
+
+		// NOTE: Reliable ids never run a window ahead of the oldest unacked
+		// one, or the receiver would take a resend of it as a duplicate
+		// (unordered) or as too far ahead (ordered). The queue is sorted
+		// by id, so the rest wait until the oldest one is acked.
+		const uint16 oldestId = (channel.count > 0) ? channel.messages[0].id : 0;
+
+		// NOTE: The count goes before the messages, so the ones that fit
+		// in the budget are counted first
+		uint8 count = 0;
+		for (uint32 i = 0; i < channel.count && count < 255; ++i)
+		{
+			const ChannelMessage &message = channel.messages[i];
+			if (message.inFlight) continue;
+			if (channelIsReliable(type) && (uint16)(message.id - oldestId) >= WINDOW_SIZE) break;
+
+			const uint32 size = headerSize + message.size;
+			if (size > budget) break;
+			budget -= size;
+			count++;
+		}
+
+		packet << count;
+
+		uint8 written = 0;
+		for (uint32 i = 0; written < count; ++i)
+		{
+			ChannelMessage &message = channel.messages[i];
+			if (message.inFlight) continue;
+			ASSERT(!channelIsReliable(type) || (uint16)(message.id - oldestId) < WINDOW_SIZE);
+
+			if (channelHasIds(type)) packet << message.id;
+			packet << message.size;
+			packet.Write(message.data, message.size);
+			written++;
+
+			if (channelIsReliable(type))
+			{
+				message.inFlight = true;
+				sentMessages.push_back({ type, message.id });
+			}
+		}
+
+		// Unreliable messages are sent only once
+		if (!channelIsReliable(type))
+		{
+			channel.count -= count;
+			memmove(channel.messages, channel.messages + count, channel.count * sizeof(ChannelMessage));
+		}
+	}
+}
+
+ChannelMessage *MessageChannelSender::findMessage(Channel &channel, uint16 id, uint32 *position)
+{
+	for (uint32 i = 0; i < channel.count; ++i)
+	{
+		if (channel.messages[i].id == id)
+		{
+			*position = i;
+			return &channel.messages[i];
+		}
+	}
+	return nullptr;
+}
+
+void MessageChannelSender::onDelivered(const SentChannelMessage &sent)
+{
+	Channel &channel = channels[(int)sent.channel];
+
+	uint32 position;
+	if (findMessage(channel, sent.id, &position) != nullptr)
+	{
+		channel.count--;
+		memmove(channel.messages + position, channel.messages + position + 1, (channel.count - position) * sizeof(ChannelMessage));
+	}
+}
+
+void MessageChannelSender::onLost(const SentChannelMessage &sent)
+{
+	uint32 position;
+	ChannelMessage *message = findMessage(channels[(int)sent.channel], sent.id, &position);
+	if (message != nullptr)
+	{
+		message->inFlight = false;
+	}
+}
+
+void MessageChannelSender::clear()
+{
+	for (Channel &channel : channels)
+	{
+		channel.count = 0;
+		channel.nextId = 0;
+	}
+}
+
+
+//////////////////////////////////////////////////////////////////////
+// MessageChannelReceiver
+//////////////////////////////////////////////////////////////////////
+
+void MessageChannelReceiver::read(const InputMemoryStream &packet)
+{
+	ChannelMessage message;
+
+	for (int c = 0; c < (int)ChannelType::Count; ++c)
+	{
+		const ChannelType type = (ChannelType)c;
+
+		uint8 count = 0;
+		packet >> count;
+		for (uint8 i = 0; i < count; ++i)
+		{
+			message.id = 0;
+			if (channelHasIds(type)) packet >> message.id;
+			packet >> message.size;
+			if (message.size > ChannelMessage::MAX_SIZE)
+			{
+				WLOG("MessageChannelReceiver::read() - malformed message of %u bytes", (uint32)message.size);
+				return;
+			}
+			packet.Read(message.data, message.size);
+
+			switch (type)
+			{
+			case ChannelType::Unreliable:
+				push(message);
+				break;
+			case ChannelType::UnreliableSequenced:
+				if (acceptSequenced(message.id)) push(message);
+				break;
+			case ChannelType::ReliableUnordered:
+				if (acceptUnordered(message.id)) push(message);
+				break;
+			case ChannelType::ReliableOrdered:
+				acceptOrdered(message);
+				break;
+			default:;
+			}
+		}
+	}
+}
+
+bool MessageChannelReceiver::receive(InputMemoryStream &stream)
+{
+	if (receivedFront == receivedBack) return false;
+
+	const ChannelMessage &message = receivedMessages[receivedFront++ % MAX_RECEIVED_MESSAGES];
+	memcpy((void*)stream.GetBufferPtr(), message.data, message.size);
+	stream.SetSize(message.size);
+	stream.Clear();
+	return true;
+}
+
+void MessageChannelReceiver::clear()
+{
+	newestSequencedId = 0xffff;
+	newestUnorderedId = 0xffff;
+	receivedUnorderedMask = 0;
+	nextOrderedId = 0;
+	for (bool &received : orderedReceived) received = false;
+	receivedFront = 0;
+	receivedBack = 0;
+}
+
+void MessageChannelReceiver::push(const ChannelMessage &message)
+{
+	if (receivedBack - receivedFront == MAX_RECEIVED_MESSAGES)
+	{
+		WLOG("MessageChannelReceiver::push() - too many messages received, dropped");
+		return;
+	}
+
+	receivedMessages[receivedBack++ % MAX_RECEIVED_MESSAGES] = message;
+}
+
+// NOTE: Ids wrap around, they are compared by their signed difference
+
+bool MessageChannelReceiver::acceptSequenced(uint16 id)
+{
+	if ((int16)(id - newestSequencedId) <= 0) return false;
+	newestSequencedId = id;
+	return true;
+}
+
+bool MessageChannelReceiver::acceptUnordered(uint16 id)
+{
+	const int16 age = (int16)(newestUnorderedId - id);
+	if (age < 0)
+	{
+		const uint32 shift = (uint32)-age;
+		receivedUnorderedMask = (shift < 64) ? (receivedUnorderedMask << shift) : 0;
+		receivedUnorderedMask |= 1; // Bit 0 is the newest id itself
+		newestUnorderedId = id;
+		return true;
+	}
+
+	// The sender never writes ids a window past its oldest unacked one,
+	// so anything older was received already
+	if (age >= 64) return false;
+
+	const uint64 bit = 1ull << age;
+	if (receivedUnorderedMask & bit) return false;
+	receivedUnorderedMask |= bit;
+	return true;
+}
+
+void MessageChannelReceiver::acceptOrdered(const ChannelMessage &message)
+{
+	const int16 ahead = (int16)(message.id - nextOrderedId);
+	if (ahead < 0) return;
+	if (ahead >= WINDOW_SIZE)
+	{
+		// The sender keeps ids within a window, this is a broken sender
+		WLOG("MessageChannelReceiver::acceptOrdered() - message %u beyond the window, dropped", (uint32)message.id);
+		return;
+	}
+
+	const uint32 slot = message.id % WINDOW_SIZE;
+	orderedMessages[slot] = message;
+	orderedReceived[slot] = true;
+
+	// Release all the consecutive messages from the next expected one
+	while (orderedReceived[nextOrderedId % WINDOW_SIZE])
+	{
+		const uint32 nextSlot = nextOrderedId % WINDOW_SIZE;
+		push(orderedMessages[nextSlot]);
+		orderedReceived[nextSlot] = false;
+		nextOrderedId++;
+	}
+}
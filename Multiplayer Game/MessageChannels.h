@@ -0,0 +1,115 @@
+#pragma once
+
+// NOTE: Message channels multiplexed over the packets of a connection.
+// Each channel has its own id sequence, and the pending messages of all
+// of them are packed together into packets that are sent anyway (the
+// replication ones), so they don't need extra datagrams. Reliability
+// relies on the DeliveryManager: the reliable messages written into a
+// packet stay in their channel's resend queue until its delivery succeeds,
+// and are written again if it fails.
+// - Unreliable: sent once, received in any order.
+// - UnreliableSequenced: sent once, the ones older than the newest
+//   received are dropped.
+// - ReliableUnordered: resent until acked, received once in any order.
+// - ReliableOrdered: resent until acked, received once and in order.
+
+enum class ChannelType : uint8
+{
+	Unreliable,
+	UnreliableSequenced,
+	ReliableUnordered,
+	ReliableOrdered,
+	Count
+};
+
+struct ChannelMessage
+{
+	static const int MAX_SIZE = 64;
+
+	uint16 id = 0;
+	uint8 size = 0;
+	bool inFlight = false; // Sender side, written into a packet not acked yet
+	char data[MAX_SIZE];
+};
+
+// Reliable message written into a packet, kept by its delivery delegate
+struct SentChannelMessage
+{
+	ChannelType channel;
+	uint16 id;
+};
+
+class MessageChannelSender
+{
+public:
+
+	static const int WINDOW_SIZE = 64; // Messages queued per channel
+	static const int MAX_BYTES_PER_PACKET = 1024;
+
+	// Queues the contents of the stream, false if it doesn't fit
+	bool send(ChannelType channel, const OutputMemoryStream &message);
+
+	// Writes the pending messages of all the channels, within the bytes
+	// per packet budget. The reliable ones are added to sentMessages.
+	void write(OutputMemoryStream &packet, std::vector<SentChannelMessage> &sentMessages);
+
+	// Outcome of the delivery of a packet with a reliable message
+	void onDelivered(const SentChannelMessage &sent);
+	void onLost(const SentChannelMessage &sent);
+
+	void clear();
+
+private:
+
+	struct Channel
+	{
+		ChannelMessage messages[WINDOW_SIZE]; // Oldest first
+		uint32 count = 0;
+		uint16 nextId = 0;
+	};
+
+	ChannelMessage *findMessage(Channel &channel, uint16 id, uint32 *position);
+
+	Channel channels[(int)ChannelType::Count];
+};
+
+class MessageChannelReceiver
+{
+public:
+
+	static const int WINDOW_SIZE = MessageChannelSender::WINDOW_SIZE;
+	static const int MAX_RECEIVED_MESSAGES = 512;
+
+	// Reads the channel messages of a packet, and queues the ones ready
+	void read(const InputMemoryStream &packet);
+
+	// Next received message, false when there are no more
+	bool receive(InputMemoryStream &message);
+
+	void clear();
+
+private:
+
+	void push(const ChannelMessage &message);
+
+	// Older, newer, or duplicated reliable messages are discarded
+	bool acceptSequenced(uint16 id);
+	bool acceptUnordered(uint16 id);
+	void acceptOrdered(const ChannelMessage &message);
+
+	// UnreliableSequenced
+	uint16 newestSequencedId = 0xffff;
+
+	// ReliableUnordered: newest id, and a bit for it and each previous one
+	uint16 newestUnorderedId = 0xffff;
+	uint64 receivedUnorderedMask = 0;
+
+	// ReliableOrdered: messages that arrived before the next expected one
+	uint16 nextOrderedId = 0;
+	ChannelMessage orderedMessages[WINDOW_SIZE];
+	bool orderedReceived[WINDOW_SIZE] = {};
+
+	ChannelMessage receivedMessages[MAX_RECEIVED_MESSAGES];
+	uint32 receivedFront = 0;
+	uint32 receivedBack = 0;
+};
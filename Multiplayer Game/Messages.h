@@ -9,8 +9,35 @@ enum class ClientMessage : uint8
 
 enum class ServerMessage : uint8
 {
+	Challenge,
 	Welcome,
 	Unwelcome,
 	Ping,   // NOTE(jesus): Use this message type in the virtual connection lab session
-	Replication
+	Replication,
+	GameEvent // Inside channel messages
 };
+
+inline const char *clientMessageName(ClientMessage message)
+{
+	switch (message)
+	{
+	case ClientMessage::Hello: return "Hello";
+	case ClientMessage::Input: return "Input";
+	case ClientMessage::Ping:  return "Ping";
+	default:                   return "Unknown";
+	}
+}
+
+inline const char *serverMessageName(ServerMessage message)
+{
+	switch (message)
+	{
+	case ServerMessage::Challenge:   return "Challenge";
+	case ServerMessage::Welcome:     return "Welcome";
+	case ServerMessage::Unwelcome:   return "Unwelcome";
+	case ServerMessage::Ping:        return "Ping";
+	case ServerMessage::Replication: return "Replication";
+	case ServerMessage::GameEvent:   return "GameEvent";
+	default:                         return "Unknown";
+	}
+}
@@ -8,9 +8,24 @@ bool ModuleBehaviour::update()
 		handleBehaviourLifeCycle(&behaviour);
 	}
 	
-	for (Projectile* behaviour : projectiles)
+	for (AxeProjectile& behaviour : axeProjectiles)
 	{
-		handleBehaviourLifeCycle(behaviour);
+		handleBehaviourLifeCycle(&behaviour);
+	}
+
+	for (StaffProjectile& behaviour : staffProjectiles)
+	{
+		handleBehaviourLifeCycle(&behaviour);
+	}
+
+	for (BowProjectile& behaviour : bowProjectiles)
+	{
+		handleBehaviourLifeCycle(&behaviour);
+	}
+
+	for (WhirlwindAxeProjectile& behaviour : whirlwindAxeProjectiles)
+	{
+		handleBehaviourLifeCycle(&behaviour);
 	}
 
 	for (Spell* behaviour : spells)
@@ -28,6 +43,9 @@ bool ModuleBehaviour::update()
 		handleBehaviourLifeCycle(&behaviour);
 	}
 
+	// Children follow the positions their parents got this frame
+	App->modGameObject->updateHierarchy();
+
 	return true;
 }
 
@@ -79,58 +97,17 @@ Player* ModuleBehaviour::addPlayer(GameObject *parentGameObject)
 	return nullptr;
 }
 
-Projectile* ModuleBehaviour::addProjectile(BehaviourType type, GameObject* parentGameObject)
+template <class T, int N>
+static T* addPooledBehaviour(T (&pool)[N], GameObject* parentGameObject)
 {
-	for (Projectile*& behaviour : projectiles)
+	for (T& behaviour : pool)
 	{
-		if (behaviour == nullptr)
-		{
-			switch (type)
-			{
-			case BehaviourType::StaffProjectile:
-				behaviour = new StaffProjectile;
-				break;
-			case BehaviourType::AxeProjectile:
-				behaviour = new AxeProjectile;
-				break;
-			case BehaviourType::BowProjectile:
-				behaviour = new BowProjectile;
-				break;
-			case BehaviourType::WhirlwindAxeProjectile:
-				behaviour = new WhirlwindAxeProjectile;
-				break;
-			default:
-				break;
-			}
-			behaviour->gameObject = parentGameObject;
-			parentGameObject->behaviour = behaviour;
-			return behaviour;
-		}
-		else
+		if (behaviour.gameObject == nullptr)
 		{
-			if (behaviour->gameObject == nullptr)
-			{
-				delete behaviour;
-				switch (type)
-				{
-				case BehaviourType::StaffProjectile:
-					behaviour = new StaffProjectile;
-					break;
-				case BehaviourType::AxeProjectile:
-					behaviour = new AxeProjectile;
-					break;
-				case BehaviourType::BowProjectile:
-					behaviour = new BowProjectile;
-					break;
-				case BehaviourType::WhirlwindAxeProjectile:
-					behaviour = new WhirlwindAxeProjectile;
-				default:
-					break;
-				}
-				behaviour->gameObject = parentGameObject;
-				parentGameObject->behaviour = behaviour;
-				return behaviour;
-			}
+			behaviour = {};
+			behaviour.gameObject = parentGameObject;
+			parentGameObject->behaviour = &behaviour;
+			return &behaviour;
 		}
 	}
 
@@ -138,6 +115,24 @@ Projectile* ModuleBehaviour::addProjectile(BehaviourType type, GameObject* paren
 	return nullptr;
 }
 
+Projectile* ModuleBehaviour::addProjectile(BehaviourType type, GameObject* parentGameObject)
+{
+	switch (type)
+	{
+	case BehaviourType::StaffProjectile:
+		return addPooledBehaviour(staffProjectiles, parentGameObject);
+	case BehaviourType::AxeProjectile:
+		return addPooledBehaviour(axeProjectiles, parentGameObject);
+	case BehaviourType::BowProjectile:
+		return addPooledBehaviour(bowProjectiles, parentGameObject);
+	case BehaviourType::WhirlwindAxeProjectile:
+		return addPooledBehaviour(whirlwindAxeProjectiles, parentGameObject);
+	default:
+		ASSERT(false);
+		return nullptr;
+	}
+}
+
 DeathGhost* ModuleBehaviour::addDeathGhost(GameObject* parentGameObject)
 {
 	for (DeathGhost& behaviour : deathGhosts)
@@ -225,18 +220,43 @@ Spell* ModuleBehaviour::addSpell(BehaviourType behaviourType, GameObject* parent
 }
 
 
-std::list<Player> ModuleBehaviour::GetPlayersList()
+static bool rankedBefore(const Player& first, const Player& second)
+{
+	if (first.level == second.level)
+		return (first.name < second.name);
+	else
+		return (first.level > second.level);
+}
+
+void ModuleBehaviour::updatePlayerRanking(const Player* player)
 {
-	std::list<Player> playersList;
-	for (Player player : players)
+	removePlayerRanking(player);
+
+	const uint8 index = (uint8)(player - players);
+	ASSERT(index < MAX_CLIENTS);
+
+	uint32 rank = rankingCount;
+	while (rank > 0 && rankedBefore(*player, players[ranking[rank - 1]]))
+	{
+		ranking[rank] = ranking[rank - 1];
+		rank--;
+	}
+	ranking[rank] = index;
+	rankingCount++;
+}
+
+void ModuleBehaviour::removePlayerRanking(const Player* player)
+{
+	const uint8 index = (uint8)(player - players);
+	for (uint32 rank = 0; rank < rankingCount; ++rank)
 	{
-		if (player.gameObject != nullptr)
+		if (ranking[rank] == index)
 		{
-			playersList.push_back(player);
+			rankingCount--;
+			memmove(ranking + rank, ranking + rank + 1, rankingCount - rank);
+			return;
 		}
 	}
-
-	return playersList;
 }
 
 void ModuleBehaviour::handleBehaviourLifeCycle(Behaviour *behaviour)
@@ -15,14 +15,32 @@ public:
 	Weapon* addWeapon(GameObject* parentGameObject);
 	Spell* addSpell(BehaviourType behaviourType, GameObject* parentGameObject);
 
-	std::list<Player> GetPlayersList();
+	// NOTE: Leaderboard, the indices of the live players sorted by level
+	// (and name on ties). Kept sorted as levels change, so reading it costs
+	// nothing.
+	void updatePlayerRanking(const Player* player);
+	void removePlayerRanking(const Player* player);
+	uint32 rankedPlayerCount() const { return rankingCount; }
+	const Player& rankedPlayer(uint32 rank) const { return players[ranking[rank]]; }
 
 private:
 
 	void handleBehaviourLifeCycle(Behaviour * behaviour);
 
 	Player players[MAX_CLIENTS];
-	Projectile* projectiles[MAX_GAME_OBJECTS];
+	uint8 ranking[MAX_CLIENTS] = {};
+	uint32 rankingCount = 0;
+
+	// NOTE: One fixed pool per projectile type, a slot is free while its
+	// gameObject is null. Room for two whirlwinds per player, as the axes
+	// of the previous one can still be destroying when casting again.
+	static const int MAX_PROJECTILES = 512;
+	static const int MAX_WHIRLWIND_AXES = 2 * MAX_CLIENTS * AxeSpell::NUM_AXES;
+	AxeProjectile axeProjectiles[MAX_PROJECTILES];
+	StaffProjectile staffProjectiles[MAX_PROJECTILES];
+	BowProjectile bowProjectiles[MAX_PROJECTILES];
+	WhirlwindAxeProjectile whirlwindAxeProjectiles[MAX_WHIRLWIND_AXES];
+
 	DeathGhost deathGhosts[MAX_CLIENTS];
 	Weapon weapons[MAX_CLIENTS];
 	Spell* spells[MAX_CLIENTS];
@@ -25,7 +25,7 @@ static bool collisionTestOverSeparatingAxis(
 
 static bool collisionTest(CollisionData &c1, CollisionData &c2)
 {
-	BEGIN_TIMED_BLOCK(CollisionTest);
+	PROFILE_SCOPE("CollisionTest");
 
 	bool areColliding = false;
 
@@ -41,8 +41,6 @@ static bool collisionTest(CollisionData &c1, CollisionData &c2)
 		}
 	}
 
-	END_TIMED_BLOCK(CollisionTest);
-
 	return areColliding;
 }
 
@@ -80,83 +78,86 @@ void ModuleCollision::removeCollider(Collider *collider)
 
 bool ModuleCollision::update()
 {
-	BEGIN_TIMED_BLOCK(Collisions);
+	PROFILE_SCOPE("Collisions");
 
-	BEGIN_TIMED_BLOCK(Collisions1);
 	// Pack colliders in activeColliders contiguously
 	uint32 activeCollidersCount = 0;
-	for (unsigned int i = 0; i < MAX_COLLIDERS && activeCollidersCount < collidersCount; ++i)
 	{
-		Collider *collider = &colliders[i];
+		PROFILE_SCOPE("PackColliders");
 
-		if (collider->type != ColliderType::None)
+		for (unsigned int i = 0; i < MAX_COLLIDERS && activeCollidersCount < collidersCount; ++i)
 		{
-			// Handle game object destruction
-			GameObject *go = collider->gameObject;
-			ASSERT(go != nullptr);
+			Collider *collider = &colliders[i];
 
-			if (go->state == GameObject::DESTROYING)
+			if (collider->type != ColliderType::None)
 			{
-				App->modCollision->removeCollider(collider);
-				continue;
-			}
+				// Handle game object destruction
+				GameObject *go = collider->gameObject;
+				ASSERT(go != nullptr);
 
-			if (go->state == GameObject::UPDATING && collider->enabled)
-			{
-				// Precompute collision data and store it into activeColliders
-				Sprite *sprite = go->sprite;
-				ASSERT(sprite != nullptr);
-
-				vec2 size = isZero(go->size) ? (sprite->texture ? sprite->texture->size : vec2{ 100.0f, 100.0f }) : go->size;
-
-				mat4 aWorldMatrix =
-					translation(go->position) *
-					rotationZ(radiansFromDegrees(go->angle)) *
-					scaling(size) *
-					translation(vec2{ 0.5f, 0.5f } -sprite->pivot);
-
-				activeColliders[activeCollidersCount].collider = collider;
-				activeColliders[activeCollidersCount].p1 = vec2_cast(aWorldMatrix * vec4{ -0.5f, -0.5f, 0.0f, 1.0f });
-				activeColliders[activeCollidersCount].p2 = vec2_cast(aWorldMatrix * vec4{ 0.5f, -0.5f, 0.0f, 1.0f });
-				activeColliders[activeCollidersCount].p3 = vec2_cast(aWorldMatrix * vec4{ 0.5f,  0.5f, 0.0f, 1.0f });
-				activeColliders[activeCollidersCount].p4 = vec2_cast(aWorldMatrix * vec4{ -0.5f,  0.5f, 0.0f, 1.0f });
-				activeColliders[activeCollidersCount].behaviour = (collider->isTrigger) ? collider->gameObject->behaviour : nullptr;
-				activeCollidersCount++;
+				if (go->state == GameObject::DESTROYING)
+				{
+					App->modCollision->removeCollider(collider);
+					continue;
+				}
+
+				if (go->state == GameObject::UPDATING && collider->enabled)
+				{
+					// Precompute collision data and store it into activeColliders
+					Sprite *sprite = go->sprite;
+					ASSERT(sprite != nullptr);
+
+					vec2 size = isZero(go->size()) ? (sprite->texture ? sprite->texture->size : vec2{ 100.0f, 100.0f }) : go->size();
+
+					mat4 aWorldMatrix =
+						translation(go->position()) *
+						rotationZ(radiansFromDegrees(go->angle())) *
+						scaling(size) *
+						translation(vec2{ 0.5f, 0.5f } -sprite->pivot);
+
+					activeColliders[activeCollidersCount].collider = collider;
+					activeColliders[activeCollidersCount].p1 = vec2_cast(aWorldMatrix * vec4{ -0.5f, -0.5f, 0.0f, 1.0f });
+					activeColliders[activeCollidersCount].p2 = vec2_cast(aWorldMatrix * vec4{ 0.5f, -0.5f, 0.0f, 1.0f });
+					activeColliders[activeCollidersCount].p3 = vec2_cast(aWorldMatrix * vec4{ 0.5f,  0.5f, 0.0f, 1.0f });
+					activeColliders[activeCollidersCount].p4 = vec2_cast(aWorldMatrix * vec4{ -0.5f,  0.5f, 0.0f, 1.0f });
+					activeColliders[activeCollidersCount].behaviour = (collider->isTrigger) ? collider->gameObject->behaviour : nullptr;
+					activeCollidersCount++;
+				}
 			}
 		}
 	}
-	END_TIMED_BLOCK(Collisions1);
 
-	BEGIN_TIMED_BLOCK(Collisions2);
 	// Traverse all active colliders
-	for (uint32 i = 0; i < activeCollidersCount; ++i)
 	{
-		CollisionData &c1 = activeColliders[i];
+		PROFILE_SCOPE("TestColliders");
 
-		for (uint32 j = i + 1; j < activeCollidersCount; ++j)
+		for (uint32 i = 0; i < activeCollidersCount; ++i)
 		{
-			CollisionData &c2 = activeColliders[j];
+			CollisionData &c1 = activeColliders[i];
 
-			if ((c1.behaviour != nullptr) ||
-				(c2.behaviour != nullptr))
+			for (uint32 j = i + 1; j < activeCollidersCount; ++j)
 			{
-				if (collisionTest(c1, c2))
+				CollisionData &c2 = activeColliders[j];
+
+				if ((c1.behaviour != nullptr) ||
+					(c2.behaviour != nullptr))
 				{
-					if (c1.behaviour)
-					{
-						c1.behaviour->onCollisionTriggered(*c1.collider, *c2.collider);
-					}
-					if (c2.behaviour)
+					if (collisionTest(c1, c2))
 					{
-						c2.behaviour->onCollisionTriggered(*c2.collider, *c1.collider);
+						if (c1.behaviour)
+						{
+							c1.behaviour->onCollisionTriggered(*c1.collider, *c2.collider);
+						}
+						if (c2.behaviour)
+						{
+							c2.behaviour->onCollisionTriggered(*c2.collider, *c1.collider);
+						}
 					}
 				}
 			}
 		}
 	}
-	END_TIMED_BLOCK(Collisions2);
 
-	END_TIMED_BLOCK(Collisions);
 	return true;
 }
 
@@ -3,12 +3,23 @@
 
 bool ModuleGameObject::init()
 {
+	// Push the slots in reverse order so that lower indices are used first
+	freeGameObjectCount = 0;
+	for (uint32 i = MAX_GAME_OBJECTS; i > 0; --i)
+	{
+		freeGameObjectIndices[freeGameObjectCount++] = i - 1;
+	}
+
+	activeGameObjectCount = 0;
+	childGameObjectCount = 0;
+	delayedDestructions.clear(Time.time);
+
 	return true;
 }
 
 bool ModuleGameObject::preUpdate()
 {
-	BEGIN_TIMED_BLOCK(GOPreUpdate);
+	PROFILE_SCOPE("GOPreUpdate");
 
 	static const GameObject::State gNextState[] = {
 		GameObject::NON_EXISTING, // After NON_EXISTING
@@ -19,12 +30,18 @@ bool ModuleGameObject::preUpdate()
 		GameObject::NON_EXISTING  // After DESTROYING
 	};
 
-	for (GameObject &gameObject : gameObjects)
+	// NOTE: Traversed backwards, releaseGameObject() moves the last
+	// entry (already visited) into the released position
+	for (uint32 i = activeGameObjectCount; i > 0; --i)
 	{
+		GameObject &gameObject = gameObjects[activeGameObjectIndices[i - 1]];
 		gameObject.state = gNextState[gameObject.state];
-	}
 
-	END_TIMED_BLOCK(GOPreUpdate);
+		if (gameObject.state == GameObject::NON_EXISTING)
+		{
+			releaseGameObject(gameObject.id);
+		}
+	}
 
 	return true;
 }
@@ -32,17 +49,12 @@ bool ModuleGameObject::preUpdate()
 bool ModuleGameObject::update()
 {
 	// Delayed destructions
-	for (DelayedDestroyEntry &destroyEntry : gameObjectsWithDelayedDestruction)
+	delayedDestructions.advance(Time.time);
+
+	uint32 index;
+	while (delayedDestructions.popExpired(&index))
 	{
-		if (destroyEntry.object != nullptr)
-		{
-			destroyEntry.delaySeconds -= Time.deltaTime;
-			if (destroyEntry.delaySeconds <= 0.0f)
-			{
-				Destroy(destroyEntry.object);
-				destroyEntry.object = nullptr;
-			}
-		}
+		Destroy(&gameObjects[index]);
 	}
 
 	return true;
@@ -60,21 +72,28 @@ bool ModuleGameObject::cleanUp()
 
 GameObject * ModuleGameObject::Instantiate()
 {
-	for (uint32 i = 0; i < MAX_GAME_OBJECTS; ++i)
-	{
-		GameObject &gameObject = App->modGameObject->gameObjects[i];
+	ModuleGameObject *module = App->modGameObject;
 
-		if (gameObject.state == GameObject::NON_EXISTING)
-		{
-			gameObject = GameObject();
-			gameObject.id = i;
-			gameObject.state = GameObject::INSTANTIATE;
-			return &gameObject;
-		}
-	}
+	ASSERT(module->freeGameObjectCount > 0); // NOTE(jesus): You need to increase MAX_GAME_OBJECTS in case this assert crashes
 
-	ASSERT(0); // NOTE(jesus): You need to increase MAX_GAME_OBJECTS in case this assert crashes
-	return nullptr;
+	uint32 index = module->freeGameObjectIndices[--module->freeGameObjectCount];
+	GameObject &gameObject = module->gameObjects[index];
+	ASSERT(gameObject.state == GameObject::NON_EXISTING);
+
+	gameObject = GameObject();
+	gameObject.id = index;
+	gameObject.state = GameObject::INSTANTIATE;
+
+	module->positions[index] = vec2{ 0.0f, 0.0f };
+	module->sizes[index] = vec2{ 0.0f, 0.0f };
+	module->angles[index] = 0.0f;
+	module->interpolations[index] = ModuleGameObject::Interpolation();
+	module->hierarchies[index] = ModuleGameObject::Hierarchy();
+
+	module->activeGameObjectPositions[index] = module->activeGameObjectCount;
+	module->activeGameObjectIndices[module->activeGameObjectCount++] = index;
+
+	return &gameObject;
 }
 
 void ModuleGameObject::Destroy(GameObject * gameObject)
@@ -92,17 +111,220 @@ void ModuleGameObject::Destroy(GameObject * gameObject)
 
 	ASSERT(gameObject->state < GameObject::STATE_COUNT);
 	gameObject->state = gNextState[gameObject->state];
+
+	// NOTE: Network children are destroyed by the networking modules,
+	// which have to unregister them first
+	ModuleGameObject *module = App->modGameObject;
+	for (uint32 i = 0; i < module->childGameObjectCount; ++i)
+	{
+		GameObject &child = module->gameObjects[module->childGameObjectIndices[i]];
+		if (module->hierarchies[child.id].parent == gameObject->id && child.networkId == 0 &&
+			child.state != GameObject::DESTROY && child.state != GameObject::DESTROYING)
+		{
+			Destroy(&child);
+		}
+	}
 }
 
 void ModuleGameObject::Destroy(GameObject * gameObject, float delaySeconds)
 {
-	for (uint32 i = 0; i < MAX_GAME_OBJECTS; ++i)
+	ModuleGameObject *module = App->modGameObject;
+
+	// NOTE: If the object was already scheduled, the earliest time is kept
+	module->delayedDestructions.schedule(gameObject->id, Time.time + delaySeconds);
+}
+
+void ModuleGameObject::releaseGameObject(uint32 index)
+{
+	ASSERT(activeGameObjectCount > 0);
+
+	// Swap-remove from the dense list of active game objects
+	uint32 position = activeGameObjectPositions[index];
+	uint32 lastIndex = activeGameObjectIndices[--activeGameObjectCount];
+	activeGameObjectIndices[position] = lastIndex;
+	activeGameObjectPositions[lastIndex] = position;
+
+	// The slot will be reused, forget any pending delayed destruction
+	delayedDestructions.cancel(index);
+
+	// Detach it from the hierarchy, children still alive (e.g. network
+	// ones waiting for their destruction) stay where they are, as roots
+	const uint32 releasedDepth = hierarchies[index].depth;
+	if (hierarchies[index].parent != NO_PARENT || hierarchies[index].parentNetworkId != 0)
+	{
+		removeChild(index);
+	}
+	shiftDescendants(index, -(int32)(releasedDepth + 1));
+
+	uint32 keptCount = 0;
+	for (uint32 i = 0; i < childGameObjectCount; ++i)
+	{
+		const uint32 childIndex = childGameObjectIndices[i];
+		if (hierarchies[childIndex].parent == index)
+		{
+			hierarchies[childIndex].parent = NO_PARENT; // Already at depth 0
+		}
+		else
+		{
+			childGameObjectIndices[keptCount++] = childIndex;
+		}
+	}
+	childGameObjectCount = keptCount;
+	hierarchies[index] = Hierarchy();
+
+	freeGameObjectIndices[freeGameObjectCount++] = index;
+}
+
+void ModuleGameObject::setParent(uint32 index, uint32 parentIndex, uint32 parentNetworkId)
+{
+	ASSERT(index != parentIndex);
+	ASSERT(parentIndex == NO_PARENT || !isDescendant(parentIndex, index)); // No cycles
+
+	Hierarchy &hierarchy = hierarchies[index];
+	const uint32 previousDepth = hierarchy.depth;
+	if (hierarchy.parent != NO_PARENT || hierarchy.parentNetworkId != 0)
+	{
+		removeChild(index);
+	}
+
+	hierarchy.parent = parentIndex;
+	hierarchy.parentNetworkId = (parentIndex == NO_PARENT) ? parentNetworkId : 0;
+	hierarchy.depth = 0;
+
+	if (hierarchy.parent != NO_PARENT || hierarchy.parentNetworkId != 0)
+	{
+		hierarchy.depth = (parentIndex != NO_PARENT) ? hierarchies[parentIndex].depth + 1 : 1;
+		insertChild(index);
+	}
+
+	// Its own descendants have to stay after it, move them along
+	if (hierarchy.depth != previousDepth)
+	{
+		shiftDescendants(index, (int32)hierarchy.depth - (int32)previousDepth);
+	}
+}
+
+bool ModuleGameObject::isDescendant(uint32 index, uint32 ancestor) const
+{
+	for (uint32 parent = hierarchies[index].parent; parent != NO_PARENT; parent = hierarchies[parent].parent)
+	{
+		if (parent == ancestor) return true;
+	}
+	return false;
+}
+
+void ModuleGameObject::shiftDescendants(uint32 index, int32 depthDelta)
+{
+	// Split the list into the descendants and the rest, both stay sorted
+	// as all the descendants change their depth by the same amount
+	uint32 keptCount = 0;
+	uint32 movedCount = 0;
+	for (uint32 i = 0; i < childGameObjectCount; ++i)
+	{
+		const uint32 childIndex = childGameObjectIndices[i];
+		if (isDescendant(childIndex, index))
+		{
+			hierarchies[childIndex].depth = (uint32)((int32)hierarchies[childIndex].depth + depthDelta);
+			movedChildIndices[movedCount++] = childIndex;
+		}
+		else
+		{
+			childGameObjectIndices[keptCount++] = childIndex;
+		}
+	}
+
+	// Merge them back from the end
+	uint32 position = keptCount + movedCount;
+	while (movedCount > 0)
 	{
-		if (App->modGameObject->gameObjectsWithDelayedDestruction[i].object == nullptr)
+		if (keptCount > 0 && hierarchies[childGameObjectIndices[keptCount - 1]].depth > hierarchies[movedChildIndices[movedCount - 1]].depth)
+		{
+			childGameObjectIndices[--position] = childGameObjectIndices[--keptCount];
+		}
+		else
 		{
-			App->modGameObject->gameObjectsWithDelayedDestruction[i].object = gameObject;
-			App->modGameObject->gameObjectsWithDelayedDestruction[i].delaySeconds = delaySeconds;
-			break;
+			childGameObjectIndices[--position] = movedChildIndices[--movedCount];
+		}
+	}
+}
+
+void ModuleGameObject::insertChild(uint32 index)
+{
+	const uint32 depth = hierarchies[index].depth;
+
+	uint32 position = childGameObjectCount;
+	while (position > 0 && hierarchies[childGameObjectIndices[position - 1]].depth > depth)
+	{
+		childGameObjectIndices[position] = childGameObjectIndices[position - 1];
+		position--;
+	}
+
+	childGameObjectIndices[position] = index;
+	childGameObjectCount++;
+}
+
+void ModuleGameObject::removeChild(uint32 index)
+{
+	for (uint32 i = 0; i < childGameObjectCount; ++i)
+	{
+		if (childGameObjectIndices[i] == index)
+		{
+			memmove(&childGameObjectIndices[i], &childGameObjectIndices[i + 1], (childGameObjectCount - i - 1) * sizeof(uint32));
+			childGameObjectCount--;
+			return;
+		}
+	}
+
+	ASSERT(false);
+}
+
+GameObject * ModuleGameObject::findNetworkChild(GameObject *parent)
+{
+	for (uint32 i = 0; i < childGameObjectCount; ++i)
+	{
+		GameObject &child = gameObjects[childGameObjectIndices[i]];
+		if (hierarchies[child.id].parent == parent->id && child.networkId != 0)
+		{
+			return &child;
+		}
+	}
+
+	return nullptr;
+}
+
+void ModuleGameObject::updateHierarchy()
+{
+	PROFILE_SCOPE("Hierarchy");
+
+	// Parents replicated after their children, collected first as
+	// attaching them reorders the list
+	uint32 resolvedCount = 0;
+	for (uint32 i = 0; i < childGameObjectCount; ++i)
+	{
+		const uint32 index = childGameObjectIndices[i];
+		if (hierarchies[index].parent == NO_PARENT)
+		{
+			GameObject *parent = App->modLinkingContext->getNetworkGameObject(hierarchies[index].parentNetworkId);
+			if (parent != nullptr && parent != &gameObjects[index])
+			{
+				resolvedChildIndices[resolvedCount++] = index;
+			}
+		}
+	}
+	for (uint32 i = 0; i < resolvedCount; ++i)
+	{
+		const uint32 index = resolvedChildIndices[i];
+		GameObject *parent = App->modLinkingContext->getNetworkGameObject(hierarchies[index].parentNetworkId);
+		setParent(index, parent->id, 0);
+	}
+
+	for (uint32 i = 0; i < childGameObjectCount; ++i)
+	{
+		const uint32 index = childGameObjectIndices[i];
+		const Hierarchy &hierarchy = hierarchies[index];
+		if (hierarchy.parent != NO_PARENT)
+		{
+			positions[index] = positions[hierarchy.parent] + hierarchy.localPosition;
 		}
 	}
 }
@@ -123,32 +345,144 @@ void Destroy(GameObject * gameObject, float delaySeconds)
 	ModuleGameObject::Destroy(gameObject, delaySeconds);
 }
 
+vec2 & GameObject::position()
+{
+	return App->modGameObject->positions[id];
+}
+
+vec2 & GameObject::size()
+{
+	return App->modGameObject->sizes[id];
+}
+
+float & GameObject::angle()
+{
+	return App->modGameObject->angles[id];
+}
+
+vec2 & GameObject::initial_position()
+{
+	return App->modGameObject->interpolations[id].initial_position;
+}
+
+vec2 & GameObject::initial_size()
+{
+	return App->modGameObject->interpolations[id].initial_size;
+}
+
+float & GameObject::initial_angle()
+{
+	return App->modGameObject->interpolations[id].initial_angle;
+}
+
+vec2 & GameObject::final_position()
+{
+	return App->modGameObject->interpolations[id].final_position;
+}
+
+vec2 & GameObject::final_size()
+{
+	return App->modGameObject->interpolations[id].final_size;
+}
+
+float & GameObject::final_angle()
+{
+	return App->modGameObject->interpolations[id].final_angle;
+}
+
+float & GameObject::secondsElapsed()
+{
+	return App->modGameObject->interpolations[id].secondsElapsed;
+}
+
+void GameObject::setParent(GameObject *parent, vec2 localPosition)
+{
+	ModuleGameObject *module = App->modGameObject;
+	module->setParent(id, parent != nullptr ? parent->id : ModuleGameObject::NO_PARENT, 0);
+	module->hierarchies[id].localPosition = localPosition;
+
+	if (parent != nullptr)
+	{
+		position() = parent->position() + localPosition;
+	}
+}
+
+GameObject * GameObject::parent()
+{
+	ModuleGameObject *module = App->modGameObject;
+	const uint32 parentIndex = module->hierarchies[id].parent;
+	return (parentIndex != ModuleGameObject::NO_PARENT) ? &module->gameObjects[parentIndex] : nullptr;
+}
+
+vec2 & GameObject::localPosition()
+{
+	return App->modGameObject->hierarchies[id].localPosition;
+}
+
 void GameObject::Interpolate()
 {
-	float t = secondsElapsed / REPLICATION_INTERVAL_SECONDS;
+	ModuleGameObject::Interpolation &interpolation = App->modGameObject->interpolations[id];
+
+	float t = interpolation.secondsElapsed / REPLICATION_INTERVAL_SECONDS;
 
 	if (t < 1)
 	{
-		position = lerp(initial_position, final_position, t);
-		angle = lerp(initial_angle, final_angle, t);
-		size = lerp(initial_size, final_size, t);
+		position() = lerp(interpolation.initial_position, interpolation.final_position, t);
+		angle() = lerp(interpolation.initial_angle, interpolation.final_angle, t);
+		size() = lerp(interpolation.initial_size, interpolation.final_size, t);
 
-		secondsElapsed += Time.deltaTime;
+		interpolation.secondsElapsed += Time.deltaTime;
+	}
+}
+
+// NOTE: Children with a network parent only send their local position
+static uint32 parentNetworkId(GameObject *gameObject)
+{
+	GameObject *parent = gameObject->parent();
+	return (parent != nullptr) ? parent->networkId : 0;
+}
+
+static void readParent(GameObject *gameObject, uint32 parentNetworkId, vec2 localPosition)
+{
+	ModuleGameObject *module = App->modGameObject;
+	GameObject *parent = App->modLinkingContext->getNetworkGameObject(parentNetworkId);
+	if (parent != nullptr && parent != gameObject)
+	{
+		if (gameObject->parent() != parent)
+		{
+			gameObject->setParent(parent, localPosition);
+		}
+	}
+	else if (module->hierarchies[gameObject->id].parentNetworkId != parentNetworkId)
+	{
+		// Resolved later, once the parent is created
+		module->setParent(gameObject->id, ModuleGameObject::NO_PARENT, parentNetworkId);
 	}
+	gameObject->localPosition() = localPosition;
 }
 
 void GameObject::writeCreate(OutputMemoryStream& packet)
 {
 	//Write object properties
-	packet.Write(this->position.x);
-	packet.Write(this->position.y);
-	packet.Write(this->initial_position.x);
-	packet.Write(this->initial_position.y);
+	const uint32 parentId = parentNetworkId(this);
+	packet.Write(parentId);
+	if (parentId != 0)
+	{
+		packet.Write(this->localPosition().x);
+		packet.Write(this->localPosition().y);
+	}
+	else
+	{
+		packet.Write(this->position().x);
+		packet.Write(this->position().y);
+		packet.Write(this->initial_position().x);
+		packet.Write(this->initial_position().y);
+	}
 
-	packet.Write(this->size.x);
-	packet.Write(this->size.y);
+	packet.Write(this->size().x);
+	packet.Write(this->size().y);
 
-	packet.Write(this->angle);
+	packet.Write(this->angle());
 
 	//If it has a sprite, write it
 	if (this->sprite)
@@ -194,13 +528,23 @@ void GameObject::writeCreate(OutputMemoryStream& packet)
 
 void GameObject::writeUpdate(OutputMemoryStream& packet)
 {
-	packet.Write(this->position.x);
-	packet.Write(this->position.y);
+	const uint32 parentId = parentNetworkId(this);
+	packet.Write(parentId);
+	if (parentId != 0)
+	{
+		packet.Write(this->localPosition().x);
+		packet.Write(this->localPosition().y);
+	}
+	else
+	{
+		packet.Write(this->position().x);
+		packet.Write(this->position().y);
+	}
 
-	packet.Write(this->size.x);
-	packet.Write(this->size.y);
+	packet.Write(this->size().x);
+	packet.Write(this->size().y);
 
-	packet.Write(this->angle);
+	packet.Write(this->angle());
 
 	if (this->sprite)
 	{
@@ -238,21 +582,34 @@ void GameObject::writeUpdate(OutputMemoryStream& packet)
 
 void GameObject::readCreate(const InputMemoryStream& packet)
 {
-	packet.Read(this->position.x);
-	packet.Read(this->position.y);
+	uint32 parentId = 0;
+	packet.Read(parentId);
+	if (parentId != 0)
+	{
+		vec2 localPosition;
+		packet.Read(localPosition.x);
+		packet.Read(localPosition.y);
+		readParent(this, parentId, localPosition);
+		initial_position() = position();
+	}
+	else
+	{
+		packet.Read(this->position().x);
+		packet.Read(this->position().y);
 
-	packet.Read(this->initial_position.x);
-	packet.Read(this->initial_position.y);
-	final_position = position;
+		packet.Read(this->initial_position().x);
+		packet.Read(this->initial_position().y);
+	}
+	final_position() = position();
 
-	packet.Read(this->size.x);
-	packet.Read(this->size.y);
+	packet.Read(this->size().x);
+	packet.Read(this->size().y);
 
-	initial_size = final_size = size;
+	initial_size() = final_size() = size();
 
-	packet.Read(this->angle);
+	packet.Read(this->angle());
 
-	initial_angle = final_angle = angle;
+	initial_angle() = final_angle() = angle();
 
 	bool ret = false;
 	packet.Read(ret);
@@ -297,31 +654,53 @@ void GameObject::readCreate(const InputMemoryStream& packet)
 
 void GameObject::readUpdate(const InputMemoryStream& packet)
 {
+	uint32 parentId = 0;
+	packet.Read(parentId);
+	if (parentId != 0)
+	{
+		// The position follows the (interpolated) parent, nothing to lerp
+		vec2 localPosition;
+		packet.Read(localPosition.x);
+		packet.Read(localPosition.y);
+		readParent(this, parentId, localPosition);
+		initial_position() = final_position() = position();
+	}
+	else if (parent() != nullptr || App->modGameObject->hierarchies[id].parentNetworkId != 0)
+	{
+		setParent(nullptr);
+	}
+
 	if (networkInterpolationEnabled)
 	{
-		initial_position = position;
-		initial_angle = angle;
+		initial_position() = position();
+		initial_angle() = angle();
 
-		packet.Read(final_position.x);
-		packet.Read(final_position.y);
+		if (parentId == 0)
+		{
+			packet.Read(final_position().x);
+			packet.Read(final_position().y);
+		}
 
-		packet.Read(final_size.x);
-		packet.Read(final_size.y);
-		initial_size = size = final_size;
+		packet.Read(final_size().x);
+		packet.Read(final_size().y);
+		initial_size() = size() = final_size();
 
-		packet.Read(final_angle);
+		packet.Read(final_angle());
 
-		secondsElapsed = 0;
+		secondsElapsed() = 0;
 	}
 	else
 	{
-		packet.Read(position.x);
-		packet.Read(position.y);
+		if (parentId == 0)
+		{
+			packet.Read(position().x);
+			packet.Read(position().y);
+		}
 
-		packet.Read(size.x);
-		packet.Read(size.y);
+		packet.Read(size().x);
+		packet.Read(size().y);
 
-		packet.Read(angle);
+		packet.Read(angle());
 	}
 
 	//If it has a sprite, read it
@@ -5,9 +5,12 @@ struct GameObject
 	uint32 id;
 
 	// Transform component
-	vec2 position = vec2{ 0.0f, 0.0f };
-	vec2 size = vec2{ 0.0f, 0.0f }; // NOTE(jesus): If equals 0, it takes the size of the texture
-	float angle = 0.0f;
+	// NOTE: The actual values live in the structure of arrays kept by
+	// ModuleGameObject (indexed by id), these accessors return references
+	// into them so they can be used as if they were plain members.
+	vec2 &position();
+	vec2 &size(); // NOTE(jesus): If equals 0, it takes the size of the texture
+	float &angle();
 
 	// Render component
 	Sprite *sprite = nullptr;
@@ -40,17 +43,26 @@ struct GameObject
 	State state = NON_EXISTING;
 
 
-	// Interpolation Component
+	// Interpolation Component (also stored in ModuleGameObject)
 	void Interpolate();
-	vec2 initial_position = vec2{ 0.0f, 0.0f };
-	vec2 initial_size = vec2{ 0.0f, 0.0f };
-	float initial_angle = 0.0f;
+	vec2 &initial_position();
+	vec2 &initial_size();
+	float &initial_angle();
 
-	vec2 final_position = vec2{ 0.0f, 0.0f };
-	vec2 final_size = vec2{ 0.0f, 0.0f };
-	float final_angle = 0.0f;
+	vec2 &final_position();
+	vec2 &final_size();
+	float &final_angle();
 
-	float secondsElapsed = 0.0f;
+	float &secondsElapsed();
+	////////////////////////////
+
+	// Hierarchy component (also stored in ModuleGameObject)
+	// NOTE: The position of a child follows its parent, it is recomputed
+	// from localPosition() every frame. Only positions are relative, angle
+	// and size stay its own. Destroying a parent destroys its children.
+	void setParent(GameObject *parent, vec2 localPosition = vec2{ 0.0f, 0.0f });
+	GameObject *parent();
+	vec2 &localPosition();
 	////////////////////////////
 
 	//Serialization
@@ -91,15 +103,88 @@ public:
 
 	GameObject gameObjects[MAX_GAME_OBJECTS] = {};
 
-private:
+	// Transform components, structure of arrays indexed by GameObject::id.
+	// Kept apart from gameObjects so that the passes that only need the
+	// transforms (collisions, rendering) stream through tightly packed data.
+	vec2 positions[MAX_GAME_OBJECTS] = {};
+	vec2 sizes[MAX_GAME_OBJECTS] = {};
+	float angles[MAX_GAME_OBJECTS] = {};
 
-	struct DelayedDestroyEntry
+	// Interpolation components, indexed by GameObject::id
+	struct Interpolation
 	{
-		float delaySeconds = 0.0f;
-		GameObject *object = nullptr;
+		vec2 initial_position = vec2{ 0.0f, 0.0f };
+		vec2 initial_size = vec2{ 0.0f, 0.0f };
+		float initial_angle = 0.0f;
+
+		vec2 final_position = vec2{ 0.0f, 0.0f };
+		vec2 final_size = vec2{ 0.0f, 0.0f };
+		float final_angle = 0.0f;
+
+		float secondsElapsed = 0.0f;
 	};
 
-	DelayedDestroyEntry gameObjectsWithDelayedDestruction[MAX_GAME_OBJECTS];
+	Interpolation interpolations[MAX_GAME_OBJECTS] = {};
+
+	// Hierarchy components, indexed by GameObject::id
+	static const uint32 NO_PARENT = 0xffffffff;
+
+	struct Hierarchy
+	{
+		uint32 parent = NO_PARENT;
+		uint32 parentNetworkId = 0; // Parent not replicated yet (clients)
+		uint32 depth = 0;
+		vec2 localPosition = vec2{ 0.0f, 0.0f };
+	};
+
+	Hierarchy hierarchies[MAX_GAME_OBJECTS] = {};
+
+	void setParent(uint32 index, uint32 parentIndex, uint32 parentNetworkId);
+
+	// Network children of a game object, to destroy them along with it
+	GameObject *findNetworkChild(GameObject *parent);
+
+	// Places the children relative to their parents, called once all the
+	// behaviours have moved their game objects
+	void updateHierarchy();
+
+	// NOTE: Dense list with the indices of all the existing game objects
+	// (any state but NON_EXISTING). Iterate this instead of gameObjects
+	// so that the cost depends on the live objects, not on the capacity.
+	uint32 activeGameObjectIndices[MAX_GAME_OBJECTS] = {};
+	uint32 activeGameObjectCount = 0;
+
+private:
+
+	void releaseGameObject(uint32 index);
+
+	// Stack of free slots in gameObjects
+	uint32 freeGameObjectIndices[MAX_GAME_OBJECTS] = {};
+	uint32 freeGameObjectCount = 0;
+
+	// Position of each game object within activeGameObjectIndices
+	uint32 activeGameObjectPositions[MAX_GAME_OBJECTS] = {};
+
+	// Indices of the game objects with a parent, sorted by depth so that
+	// parents are always placed before their children
+	uint32 childGameObjectIndices[MAX_GAME_OBJECTS] = {};
+	uint32 childGameObjectCount = 0;
+
+	void insertChild(uint32 index);
+	void removeChild(uint32 index);
+
+	bool isDescendant(uint32 index, uint32 ancestor) const;
+
+	// Changes the depth of all the descendants of a game object, keeping
+	// the list sorted, in a single pass
+	void shiftDescendants(uint32 index, int32 depthDelta);
+
+	// Scratch lists, so the child list isn't reordered while scanning it
+	uint32 movedChildIndices[MAX_GAME_OBJECTS] = {};
+	uint32 resolvedChildIndices[MAX_GAME_OBJECTS] = {};
+
+	// Pending delayed destructions, keyed by game object id
+	TimerWheel delayedDestructions;
 };
 
 
@@ -66,6 +66,20 @@ void ModuleNetworking::sendPacket(const char * data, uint32 size, const sockaddr
 {
 	ASSERT(size <= DEFAULT_PACKET_SIZE); // NOTE(jesus): Increase DEFAULT_PACKET_SIZE if not enough
 
+	// NOTE: Packets keep going through the simulator until it is empty
+	// after disabling it, so they are not reordered
+	if (simulatedOutgoing.isEnabled() || simulatedOutgoing.hasPendingPackets())
+	{
+		simulatedOutgoing.enqueue(data, size, destAddress, Time.time);
+	}
+	else
+	{
+		sendPacketNow(data, size, destAddress);
+	}
+}
+
+void ModuleNetworking::sendPacketNow(const char * data, uint32 size, const sockaddr_in &destAddress)
+{
 	int byteSentCount = sendto(socket,
 		(const char*)data,
 		size,
@@ -77,7 +91,7 @@ void ModuleNetworking::sendPacket(const char * data, uint32 size, const sockaddr
 	}
 	else
 	{
-		sentPacketsCount++;
+		networkStats.onPacketSent(destAddress, data, size);
 	}
 }
 
@@ -96,7 +110,7 @@ void ModuleNetworking::reportError(const char* inOperationDesc)
 		(LPTSTR)&lpMsgBuf,
 		0, NULL);
 
-	ELOG("Error %s: %d- %s", inOperationDesc, errorNum, lpMsgBuf);
+	ELOG("Error %s: %d- %s", inOperationDesc, errorNum, (const char*)lpMsgBuf);
 }
 
 
@@ -115,15 +129,13 @@ bool ModuleNetworking::init()
 		return false;
 	}
 
-	simulatedRealWorldConditions_Init();
-
 	return true;
 }
 
 bool ModuleNetworking::start()
 {
-	sentPacketsCount = 0;
-	receivedPacketsCount = 0;
+	networkStats.reset();
+	simulatedRealWorldConditions_Reset();
 	
 	onStart();
 
@@ -134,12 +146,10 @@ bool ModuleNetworking::preUpdate()
 {
 	if (socket == INVALID_SOCKET) return true;
 
-	BEGIN_TIMED_BLOCK(NetRecv);
+	PROFILE_SCOPE("NetRecv");
 	
 	processIncomingPackets();
 
-	END_TIMED_BLOCK(NetRecv);
-
 	return true;
 }
 
@@ -147,11 +157,13 @@ bool ModuleNetworking::update()
 {
 	if (socket == INVALID_SOCKET) return true;
 
-	BEGIN_TIMED_BLOCK(NetSend);
+	PROFILE_SCOPE("NetSend");
 
 	onUpdate();
 
-	END_TIMED_BLOCK(NetSend);
+	simulatedRealWorldConditions_ProcessOutgoingPackets();
+
+	networkStats.update(isServer());
 
 	return true;
 }
@@ -163,8 +175,7 @@ bool ModuleNetworking::gui()
 		ImGui::Begin("ModuleNetworking window");
 		
 		ImGui::Text(" - Current time: %f", Time.time);
-		ImGui::Text(" - # Packet sent: %u", sentPacketsCount);
-		ImGui::Text(" - # Packet received: %u", receivedPacketsCount);
+		networkStats.gui(isServer());
 
 		ImGui::Text(" - # Networked objects: %u", App->modLinkingContext->getNetworkGameObjectsCount());
 
@@ -177,28 +188,26 @@ bool ModuleNetworking::gui()
 		// Simulate real world conditions
 		if (ImGui::CollapsingHeader("Simulate real world conditions", ImGuiTreeNodeFlags_DefaultOpen))
 		{
-			ImGui::Checkbox("Simulate latency / jitter", &simulateLatency);
-			if (simulateLatency)
+			int seed = (int)simulationSeed;
+			if (ImGui::InputInt("Random seed", &seed))
 			{
-				ImGui::InputFloat("Max. latency (s)", &simulatedLatency, 0.001f, 0.01f, 4);
-				ImGui::InputFloat("Max. jitter (s)", &simulatedJitter, 0.001f, 0.01f, 4);
-				if (ImGui::Button("Reset##defaults_latency_jitter")) {
-					simulatedLatency = 0.07f;
-					simulatedJitter = 0.03f;
-				}
+				simulationSeed = (uint32)seed;
 			}
-			ImGui::Checkbox("Simulate packet drops", &simulateDrops);
-			if (simulateDrops)
+			if (ImGui::Button("Restart simulation"))
 			{
-				ImGui::InputFloat("Drop ratio", &simulatedDropRatio, 0.01f, 0.1f, 4);
-				if (ImGui::Button("Reset##default_drop_ratio")) {
-					simulatedDropRatio = 0.01f;
-				}
-				ImGui::Text(" # Dropped packets: %d", simulatedPacketsDropped);
-				ImGui::Text(" # Received packets: %d", simulatedPacketsReceived);
+				simulatedRealWorldConditions_Reset();
 			}
 
-			ImGui::Text("Simulated buffer usage: %d%%", 100 * pendingSimulatedPacketsCount / MAX_SIMULATED_PACKETS);
+			if (ImGui::TreeNode("Incoming packets"))
+			{
+				simulatedIncoming.gui("Incoming");
+				ImGui::TreePop();
+			}
+			if (ImGui::TreeNode("Outgoing packets"))
+			{
+				simulatedOutgoing.gui("Outgoing");
+				ImGui::TreePop();
+			}
 		}
 
 		onGui();
@@ -215,13 +224,18 @@ bool ModuleNetworking::stop()
 {
 	onDisconnect();
 
+	// NOTE: Flush what the simulator still holds, e.g. the disconnection packets
+	while (const NetworkSimulator::Packet *packet = simulatedOutgoing.front(DBL_MAX))
+	{
+		sendPacketNow(packet->data, packet->size, packet->address);
+		simulatedOutgoing.pop();
+	}
+
 	closesocket(socket);
 	socket = INVALID_SOCKET;
 
-	sentPacketsCount = 0;
-	receivedPacketsCount = 0;
-
-	simulatedRandom = RandomNumberGenerator();
+	networkStats.reset();
+	simulatedRealWorldConditions_Reset();
 
 	return true;
 }
@@ -264,13 +278,13 @@ void ModuleNetworking::processIncomingPackets()
 		{
 			inPacket.SetSize(readByteCount);
 
-			if (simulateLatency || simulateDrops)
+			if (simulatedIncoming.isEnabled() || simulatedIncoming.hasPendingPackets())
 			{
-				simulatedRealWorldConditions_EnqueuePacket(inPacket, fromAddress);
+				simulatedIncoming.enqueue(inPacket.GetBufferPtr(), inPacket.GetSize(), fromAddress, Time.time);
 			}
 			else
 			{
-				receivedPacketsCount++;
+				networkStats.onPacketReceived(fromAddress, inPacket.GetBufferPtr(), inPacket.GetSize());
 				onPacketReceived(inPacket, fromAddress);
 			}
 		}
@@ -310,10 +324,7 @@ void ModuleNetworking::processIncomingPackets()
 		}
 	}
 
-	if (simulateLatency || simulateDrops)
-	{
-		simulatedRealWorldConditions_ProcessQueuedPackets();
-	}
+	simulatedRealWorldConditions_ProcessIncomingPackets();
 }
 
 
@@ -322,99 +333,33 @@ void ModuleNetworking::processIncomingPackets()
 // Real world conditions simulation
 //////////////////////////////////////////////////////////////////////
 
-void ModuleNetworking::simulatedRealWorldConditions_Init()
+void ModuleNetworking::simulatedRealWorldConditions_Reset()
 {
-	freeSimulatedPackets = nullptr;
-	pendingSimulatedPackets = nullptr;
-	pendingSimulatedPacketsCount = 0;
-	for (uint32 i = ArrayCount(simulatedPackets); i > 0; --i)
-	{
-		SimulatedPacket *next = freeSimulatedPackets;
-		freeSimulatedPackets = &simulatedPackets[i-1];
-		freeSimulatedPackets->next = next;
-	}
+	simulatedIncoming.reset(simulationSeed);
+	simulatedOutgoing.reset(simulationSeed + 1);
 }
 
-void ModuleNetworking::simulatedRealWorldConditions_EnqueuePacket(const InputMemoryStream &packet, const sockaddr_in &fromAddress)
+void ModuleNetworking::simulatedRealWorldConditions_ProcessIncomingPackets()
 {
-	float packetChance = simulatedRandom.next();
-
-	if (simulateDrops == false)
+	while (const NetworkSimulator::Packet *simulatedPacket = simulatedIncoming.front(Time.time))
 	{
-		packetChance = 1.0f;
-	}
-
-	if (packetChance > simulatedDropRatio)
-	{
-		float randomJitterFactor = 2.0f * simulatedRandom.next() - 1.0f; // from -1 to 1
-		double receptionTime = Time.time + simulatedLatency + simulatedJitter * randomJitterFactor;
-
-		if (simulateLatency == false)
-		{
-			receptionTime = Time.time;
-		}
-
-		SimulatedPacket *simulatedPacket = freeSimulatedPackets;
-		ASSERT(simulatedPacket != nullptr);
-		freeSimulatedPackets = simulatedPacket->next;
-
-		std::memcpy((void*)simulatedPacket->packet.GetBufferPtr(), packet.GetBufferPtr(), packet.GetSize());
-		simulatedPacket->packet.Clear();
-		simulatedPacket->packet.SetSize(packet.GetSize());
-		simulatedPacket->fromAddress = fromAddress;
-		simulatedPacket->receptionTime = receptionTime;
-		
-		if (pendingSimulatedPackets == nullptr || pendingSimulatedPackets->receptionTime > receptionTime)
-		{
-			simulatedPacket->next = pendingSimulatedPackets;
-			pendingSimulatedPackets = simulatedPacket;
-		}
-		else
-		{
-			for (SimulatedPacket *currentSimulatedPacket = pendingSimulatedPackets;
-				currentSimulatedPacket != nullptr;
-				currentSimulatedPacket = currentSimulatedPacket->next)
-			{
-				if (currentSimulatedPacket->next == nullptr || currentSimulatedPacket->next->receptionTime > receptionTime)
-				{
-					simulatedPacket->next = currentSimulatedPacket->next;
-					currentSimulatedPacket->next = simulatedPacket;
-					break;
-				}
-			}
-		}
-
-		pendingSimulatedPacketsCount++;
-		simulatedPacketsReceived++;
-	}
-	else
-	{
-		simulatedPacketsDropped++;
+		InputMemoryStream packet;
+		std::memcpy((void*)packet.GetBufferPtr(), simulatedPacket->data, simulatedPacket->size);
+		packet.SetSize(simulatedPacket->size);
+		const sockaddr_in fromAddress = simulatedPacket->address;
+		simulatedIncoming.pop();
+
+		networkStats.onPacketReceived(fromAddress, packet.GetBufferPtr(), packet.GetSize());
+		onPacketReceived(packet, fromAddress);
 	}
 }
 
-void ModuleNetworking::simulatedRealWorldConditions_ProcessQueuedPackets()
+void ModuleNetworking::simulatedRealWorldConditions_ProcessOutgoingPackets()
 {
-	while (pendingSimulatedPackets != nullptr)
+	while (const NetworkSimulator::Packet *simulatedPacket = simulatedOutgoing.front(Time.time))
 	{
-		SimulatedPacket *simulatedPacket = pendingSimulatedPackets;
-
-		if (simulatedPacket->receptionTime <= Time.time)
-		{
-			receivedPacketsCount++;
-			onPacketReceived(simulatedPacket->packet, simulatedPacket->fromAddress);
-
-			pendingSimulatedPackets = simulatedPacket->next;
-			simulatedPacket->next = freeSimulatedPackets;
-			freeSimulatedPackets = simulatedPacket;
-
-			ASSERT(pendingSimulatedPacketsCount > 0);
-			pendingSimulatedPacketsCount--;
-		}
-		else
-		{
-			break;
-		}
+		sendPacketNow(simulatedPacket->data, simulatedPacket->size, simulatedPacket->address);
+		simulatedOutgoing.pop();
 	}
 }
 
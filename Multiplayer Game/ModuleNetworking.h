@@ -32,6 +32,8 @@ protected:
 
 	void reportError(const char *message);
 
+	NetworkStats networkStats;
+
 
 
 private:
@@ -60,9 +62,6 @@ private:
 	// ModuleNetworking methods
 	//////////////////////////////////////////////////////////////////////
 
-	uint32 sentPacketsCount = 0;
-	uint32 receivedPacketsCount = 0;
-
 	void processIncomingPackets();
 
 	virtual void onStart() = 0;
@@ -85,33 +84,17 @@ private:
 	// Real world conditions simulation
 	//////////////////////////////////////////////////////////////////////
 
-	bool simulateLatency = false;
-	float simulatedLatency = 0.07f;
-	float simulatedJitter = 0.03f;
-	bool simulateDrops = false;
-	float simulatedDropRatio = 0.01f;
-	uint32 simulatedPacketsReceived = 0;
-	uint32 simulatedPacketsDropped = 0;
-
-	void simulatedRealWorldConditions_Init();
-
-	void simulatedRealWorldConditions_EnqueuePacket(const InputMemoryStream &packet, const sockaddr_in &fromAddress);
-
-	void simulatedRealWorldConditions_ProcessQueuedPackets();
-
-	struct SimulatedPacket {
-		InputMemoryStream packet;
-		sockaddr_in fromAddress;
-		double receptionTime;
-		SimulatedPacket *next = nullptr;
-	};
-
-	static const int MAX_SIMULATED_PACKETS = 128;
-	SimulatedPacket simulatedPackets[MAX_SIMULATED_PACKETS];
-	SimulatedPacket *freeSimulatedPackets = nullptr;
-	SimulatedPacket *pendingSimulatedPackets = nullptr;
-	RandomNumberGenerator simulatedRandom;
-	uint32 pendingSimulatedPacketsCount = 0;
+	uint32 simulationSeed = 987654321;
+	NetworkSimulator simulatedIncoming;
+	NetworkSimulator simulatedOutgoing;
+
+	void simulatedRealWorldConditions_Reset();
+
+	void simulatedRealWorldConditions_ProcessIncomingPackets();
+
+	void simulatedRealWorldConditions_ProcessOutgoingPackets();
+
+	void sendPacketNow(const char *data, uint32 size, const sockaddr_in &destAddress);
 };
 
 void NetworkDisconnect();
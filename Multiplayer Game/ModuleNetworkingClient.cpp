@@ -46,10 +46,14 @@ void ModuleNetworkingClient::onStart()
 
 	state = ClientState::Connecting;
 
+	networkStats.addConnection(serverAddress);
+
 	inputDataFront = 0;
 	inputDataBack = 0;
+	inputDataAcked = 0;
 
 	secondsSinceLastHello = 9999.0f;
+	challengeCookie = 0;
 	secondsSinceLastInputDelivery = 0.0f;
 	secondsSinceLastPing = 0.0f;
 	secondsSinceLastReceivedPacket = 0.0f;
@@ -84,7 +88,7 @@ void ModuleNetworkingClient::onGui()
 			vec2 playerPosition = {};
 			GameObject *playerGameObject = App->modLinkingContext->getNetworkGameObject(networkId);
 			if (playerGameObject != nullptr) {
-				playerPosition = playerGameObject->position;
+				playerPosition = playerGameObject->position();
 			}
 			ImGui::Text(" - Coordinates: (%f, %f)", playerPosition.x, playerPosition.y);
 
@@ -116,7 +120,14 @@ void ModuleNetworkingClient::onPacketReceived(const InputMemoryStream &packet, c
 
 	if (state == ClientState::Connecting)
 	{
-		if (message == ServerMessage::Welcome)
+		if (message == ServerMessage::Challenge)
+		{
+			packet >> challengeCookie;
+
+			// Answer right away
+			secondsSinceLastHello = 9999.0f;
+		}
+		else if (message == ServerMessage::Welcome)
 		{
 			packet >> playerId;
 			packet >> networkId;
@@ -137,8 +148,17 @@ void ModuleNetworkingClient::onPacketReceived(const InputMemoryStream &packet, c
 		{
 			// TODO(you): Reliability on top of UDP lab session
 			packet.Read(inputDataFront);
+
+			// Acks only grow, so it's fine to take them from any packet
+			uint32 nextInputToReceive;
+			packet >> nextInputToReceive;
+			inputDataAcked = min(max(inputDataAcked, nextInputToReceive), inputDataBack);
+
 			if (deliveryManager.processSequenceNumber(packet)) {
 
+				channels.read(packet);
+				processChannelMessages();
+
 				repManagerClient.read(packet);
 
 				GameObject* playerGameObject = App->modLinkingContext->getNetworkGameObject(networkId);
@@ -162,6 +182,30 @@ void ModuleNetworkingClient::onPacketReceived(const InputMemoryStream &packet, c
 	}
 }
 
+void ModuleNetworkingClient::processChannelMessages()
+{
+	InputMemoryStream message;
+	while (channels.receive(message))
+	{
+		ServerMessage type;
+		message >> type;
+
+		switch (type)
+		{
+		case ServerMessage::GameEvent:
+		{
+			GameEvent event;
+			event.read(message);
+			playGameEvent(event);
+			break;
+		}
+		default:
+			WLOG("ModuleNetworkingClient::processChannelMessages() - unexpected message %s", serverMessageName(type));
+			break;
+		}
+	}
+}
+
 void ModuleNetworkingClient::onUpdate()
 {
 	if (state == ClientState::Stopped) return;
@@ -179,6 +223,7 @@ void ModuleNetworkingClient::onUpdate()
 			OutputMemoryStream packet;
 			packet << PROTOCOL_ID;
 			packet << ClientMessage::Hello;
+			packet << challengeCookie;
 			packet << playerName;
 			packet << playerType;
 
@@ -247,29 +292,21 @@ void ModuleNetworkingClient::onUpdate()
 
 			// TODO(you): Reliability on top of UDP lab session
 
-			for (uint32 i = inputDataFront; i < inputDataBack; ++i)
+			// Only the inputs the server didn't ack yet (the front one is
+			// already processed, and wraps to 0 before the first one is)
+			const uint32 firstInputData = max(inputDataFront + 1, inputDataAcked);
+			if (firstInputData < inputDataBack)
 			{
-				InputPacketData &inputPacketData = inputData[i % ArrayCount(inputData)];
-				packet << inputPacketData.sequenceNumber;
-				packet << inputPacketData.horizontalAxis;
-				packet << inputPacketData.verticalAxis;
-				packet << inputPacketData.buttonBits;
-				packet << inputPacketData.mouseX;
-				packet << inputPacketData.mouseY;
-				packet << inputPacketData.mouseButtonBits;
+				writeInputPacketData(packet, inputData, ArrayCount(inputData), firstInputData, inputDataBack);
+				sendPacket(packet, serverAddress);
 			}
-
-			// Clear the queue
-			//inputDataFront = inputDataBack;
-
-			sendPacket(packet, serverAddress);
 		}
 
 		// Update camera for player
 		GameObject *playerGameObject = App->modLinkingContext->getNetworkGameObject(networkId);
 		if (playerGameObject != nullptr)
 		{
-			App->modRender->cameraPosition = playerGameObject->position;
+			App->modRender->cameraPosition = playerGameObject->position();
 		}
 		else
 		{
@@ -283,7 +320,7 @@ void ModuleNetworkingClient::onUpdate()
 
 		for (int i = 0; i < networkObjectsCount; ++i)
 		{
-			if (networkGameObjects[i]->networkId != networkId)
+			if (networkGameObjects[i]->networkId != networkId && networkGameObjects[i]->networkInterpolationEnabled)
 				networkGameObjects[i]->Interpolate();
 		}
 	}
@@ -309,5 +346,6 @@ void ModuleNetworkingClient::onDisconnect()
 	}
 
 	deliveryManager.clear();
+	channels.clear();
 	App->modRender->cameraPosition = {};
 }
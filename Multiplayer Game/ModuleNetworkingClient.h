@@ -64,15 +64,17 @@ private:
 	// Connecting stage
 
 	float secondsSinceLastHello = 0.0f;
+	uint64 challengeCookie = 0; // Sent back in the hello once received
 
 
 	// Input ///////////
 
-	static const int MAX_INPUT_DATA_SIMULTANEOUS_PACKETS = 64;
+	static const int MAX_INPUT_DATA_SIMULTANEOUS_PACKETS = MAX_INPUT_DATA_PER_PACKET;
 
 	InputPacketData inputData[MAX_INPUT_DATA_SIMULTANEOUS_PACKETS];
-	uint32 inputDataFront = 0;
+	uint32 inputDataFront = 0;   // Last input processed by the server (from replication)
 	uint32 inputDataBack = 0;
+	uint32 inputDataAcked = 0;   // Inputs before this one arrived to the server
 
 	float inputDeliveryIntervalSeconds = 0.05f;
 	float secondsSinceLastInputDelivery = 0.0f;
@@ -98,6 +100,9 @@ private:
 
 	// TODO(you): World state replication lab session
 	ReplicationManagerClient repManagerClient;
+	MessageChannelReceiver channels;
+
+	void processChannelMessages();
 
 
 	//////////////////////////////////////////////////////////////////////
@@ -88,3 +88,204 @@ MouseController mouseControllerFromInputPacketData(const InputPacketData& inputP
 	unpackMouseControllerButtons(inputPacketData.mouseButtonBits, mousepad);
 	return mousepad;
 }
+
+enum InputDeltaFlags : uint8
+{
+	INPUT_DELTA_HORIZONTAL_AXIS = 1 << 0,
+	INPUT_DELTA_VERTICAL_AXIS   = 1 << 1,
+	INPUT_DELTA_BUTTONS         = 1 << 2,
+	INPUT_DELTA_MOUSE_X         = 1 << 3,
+	INPUT_DELTA_MOUSE_Y         = 1 << 4,
+	INPUT_DELTA_MOUSE_BUTTONS   = 1 << 5
+};
+
+static uint8 inputDeltaFlags(const InputPacketData &previous, const InputPacketData &current)
+{
+	uint8 flags = 0;
+	if (current.horizontalAxis != previous.horizontalAxis) flags |= INPUT_DELTA_HORIZONTAL_AXIS;
+	if (current.verticalAxis != previous.verticalAxis)     flags |= INPUT_DELTA_VERTICAL_AXIS;
+	if (current.buttonBits != previous.buttonBits)         flags |= INPUT_DELTA_BUTTONS;
+	if (current.mouseX != previous.mouseX)                 flags |= INPUT_DELTA_MOUSE_X;
+	if (current.mouseY != previous.mouseY)                 flags |= INPUT_DELTA_MOUSE_Y;
+	if (current.mouseButtonBits != previous.mouseButtonBits) flags |= INPUT_DELTA_MOUSE_BUTTONS;
+	return flags;
+}
+
+void writeInputPacketData(OutputMemoryStream &packet, const InputPacketData *inputData, uint32 inputDataSize, uint32 first, uint32 last)
+{
+	ASSERT(last - first <= MAX_INPUT_DATA_PER_PACKET);
+
+	packet << first;
+	packet << (uint8)(last - first);
+
+	InputPacketData previous;
+	uint32 i = first;
+	while (i < last)
+	{
+		const InputPacketData &input = inputData[i % inputDataSize];
+		const uint8 flags = inputDeltaFlags(previous, input);
+
+		if (flags == 0)
+		{
+			uint8 repeatCount = 0;
+			while (i < last && repeatCount < 255 && inputDeltaFlags(previous, inputData[i % inputDataSize]) == 0)
+			{
+				repeatCount++;
+				i++;
+			}
+			packet << (uint8)0;
+			packet << repeatCount;
+			continue;
+		}
+
+		packet << flags;
+		if (flags & INPUT_DELTA_HORIZONTAL_AXIS) packet << input.horizontalAxis;
+		if (flags & INPUT_DELTA_VERTICAL_AXIS)   packet << input.verticalAxis;
+		if (flags & INPUT_DELTA_BUTTONS)         packet << input.buttonBits;
+		if (flags & INPUT_DELTA_MOUSE_X)         packet << input.mouseX;
+		if (flags & INPUT_DELTA_MOUSE_Y)         packet << input.mouseY;
+		if (flags & INPUT_DELTA_MOUSE_BUTTONS)   packet << input.mouseButtonBits;
+
+		previous = input;
+		i++;
+	}
+}
+
+uint32 readInputPacketData(const InputMemoryStream &packet, InputPacketData *inputData, uint32 maxInputDataCount)
+{
+	uint32 first = 0;
+	uint8 count = 0;
+	packet >> first;
+	packet >> count;
+	if (count > maxInputDataCount) return 0;
+
+	InputPacketData previous;
+	uint32 readCount = 0;
+	while (readCount < count)
+	{
+		uint8 flags = 0;
+		packet >> flags;
+
+		if (flags == 0)
+		{
+			uint8 repeatCount = 0;
+			packet >> repeatCount;
+			if (repeatCount == 0 || readCount + repeatCount > count) return 0;
+
+			for (uint8 r = 0; r < repeatCount; ++r)
+			{
+				inputData[readCount] = previous;
+				inputData[readCount].sequenceNumber = first + readCount;
+				readCount++;
+			}
+			continue;
+		}
+
+		InputPacketData input = previous;
+		if (flags & INPUT_DELTA_HORIZONTAL_AXIS) packet >> input.horizontalAxis;
+		if (flags & INPUT_DELTA_VERTICAL_AXIS)   packet >> input.verticalAxis;
+		if (flags & INPUT_DELTA_BUTTONS)         packet >> input.buttonBits;
+		if (flags & INPUT_DELTA_MOUSE_X)         packet >> input.mouseX;
+		if (flags & INPUT_DELTA_MOUSE_Y)         packet >> input.mouseY;
+		if (flags & INPUT_DELTA_MOUSE_BUTTONS)   packet >> input.mouseButtonBits;
+
+		input.sequenceNumber = first + readCount;
+		inputData[readCount++] = input;
+		previous = input;
+	}
+
+	return readCount;
+}
+
+void InputBuffer::push(const InputPacketData &input)
+{
+	if (hasNewest && input.sequenceNumber <= newestSequenceNumber) return;
+	hasNewest = true;
+	newestSequenceNumber = input.sequenceNumber;
+
+	if (count == CAPACITY)
+	{
+		dropFront();
+	}
+
+	inputs[(front + count) % CAPACITY] = input;
+	count++;
+}
+
+bool InputBuffer::pop(InputPacketData &input)
+{
+	if (refilling)
+	{
+		if (count < depth)
+		{
+			if (hasLast) repeatedCount++;
+			return false;
+		}
+		refilling = false;
+	}
+
+	if (count == 0)
+	{
+		// Underrun, buffer deeper from now on
+		depth = min(depth + 1, MAX_DEPTH);
+		refilling = true;
+		underruns++;
+		if (hasLast) repeatedCount++;
+		return false;
+	}
+
+	// Catch up, first with the ticks that were repeated meanwhile
+	while (count > depth && (repeatedCount > 0 || count > depth + MAX_EXTRA_DEPTH))
+	{
+		dropFront();
+		if (repeatedCount > 0) repeatedCount--;
+	}
+	repeatedCount = 0;
+
+	if (count > depth)
+	{
+		if (++ticksOverDepth >= SHRINK_TICKS && depth > MIN_DEPTH)
+		{
+			depth--;
+			ticksOverDepth = 0;
+		}
+	}
+	else
+	{
+		ticksOverDepth = 0;
+	}
+
+	input = inputs[front];
+	front = (front + 1) % CAPACITY;
+	count--;
+
+	hasLast = true;
+	last = input;
+	return true;
+}
+
+bool InputBuffer::lastInput(InputPacketData &input) const
+{
+	if (!hasLast) return false;
+	input = last;
+	return true;
+}
+
+void InputBuffer::clear()
+{
+	*this = InputBuffer();
+}
+
+void InputBuffer::dropFront()
+{
+	const InputPacketData &dropped = inputs[front];
+	front = (front + 1) % CAPACITY;
+	count--;
+
+	if (count > 0)
+	{
+		InputPacketData &next = inputs[front];
+		next.buttonBits |= dropped.buttonBits;
+		next.mouseButtonBits |= dropped.mouseButtonBits;
+	}
+}
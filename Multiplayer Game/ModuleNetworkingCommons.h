@@ -35,3 +35,72 @@ uint16 packMouseControllerButtons(const MouseController& input);
 void unpackMouseControllerButtons(uint16 buttonBits, MouseController& input);
 
 MouseController mouseControllerFromInputPacketData(const InputPacketData& inputPacketData, const MouseController& previousGamepad);
+
+// NOTE: Input packets carry a run of consecutive inputs, the sequence
+// number of the first one and their count. Each input is delta encoded
+// against the previous one (the first against a default input): a byte
+// with the fields that changed followed by those fields, or a zero byte
+// and the number of inputs that repeat the previous one.
+
+#define MAX_INPUT_DATA_PER_PACKET 64
+
+// Writes the inputs from first to last (not included) of a ring buffer
+void writeInputPacketData(OutputMemoryStream &packet, const InputPacketData *inputData, uint32 inputDataSize, uint32 first, uint32 last);
+
+// Returns the number of inputs read, 0 if the packet is malformed
+uint32 readInputPacketData(const InputMemoryStream &packet, InputPacketData *inputData, uint32 maxInputDataCount);
+
+// NOTE: Inputs received from a client, consumed one per server tick. A few
+// inputs are kept buffered to absorb the jitter of the input packets. The
+// depth grows on every underrun (the last input is repeated meanwhile),
+// and shrinks while the buffer stays deeper than needed. Inputs beyond
+// the target depth are dropped to catch up, their button presses merged
+// into the next one so they are not lost.
+class InputBuffer
+{
+public:
+
+	static const int CAPACITY = 32;
+	static const uint32 MIN_DEPTH = 1;
+	static const uint32 MAX_DEPTH = 8;
+	static const uint32 MAX_EXTRA_DEPTH = 3;   // Over the target before dropping inputs
+	static const uint32 SHRINK_TICKS = 120;    // Ticks over the target to shrink it
+
+	// Inputs not newer than the last one pushed are ignored
+	void push(const InputPacketData &input);
+
+	// Next input for this tick, false on underrun (or while refilling)
+	bool pop(InputPacketData &input);
+
+	// Input to repeat on underrun, false if there was none yet
+	bool lastInput(InputPacketData &input) const;
+
+	// Sequence number after the newest input pushed (0 if none yet)
+	uint32 nextToReceive() const { return hasNewest ? newestSequenceNumber + 1 : 0; }
+
+	uint32 size() const { return count; }
+	uint32 targetDepth() const { return depth; }
+	uint32 underrunCount() const { return underruns; }
+
+	void clear();
+
+private:
+
+	void dropFront();
+
+	InputPacketData inputs[CAPACITY];
+	uint32 front = 0;
+	uint32 count = 0;
+
+	bool hasNewest = false;
+	uint32 newestSequenceNumber = 0;
+
+	bool hasLast = false;
+	InputPacketData last;
+
+	bool refilling = true;
+	uint32 depth = 2;
+	uint32 ticksOverDepth = 0;
+	uint32 repeatedCount = 0; // Ticks repeated since the last catch up
+	uint32 underruns = 0;
+};
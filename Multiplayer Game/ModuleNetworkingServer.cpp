@@ -41,7 +41,12 @@ void ModuleNetworkingServer::onStart()
 
 	state = ServerState::Listening;
 
+	challengeCookies.reset();
+	rateLimiter.clear();
+
 	secondsSinceSendPingPacket = 0.0f;
+
+	netGameObjectsToDestroyWithDelay.clear(Time.time);
 }
 
 void ModuleNetworkingServer::onGui()
@@ -51,6 +56,7 @@ void ModuleNetworkingServer::onGui()
 		ImGui::Text("Connection checking info:");
 		ImGui::Text(" - Ping interval (s): %f", PING_INTERVAL_SECONDS);
 		ImGui::Text(" - Disconnection timeout (s): %f", DISCONNECT_TIMEOUT_SECONDS);
+		ImGui::Text(" - Rate limited packets: %u", rateLimiter.packetsDropped);
 
 		ImGui::Separator();
 
@@ -71,10 +77,14 @@ void ModuleNetworkingServer::onGui()
 					ImGui::Text(" - port: %d", ntohs(clientProxies[i].address.sin_port));
 					ImGui::Text(" - name: %s", clientProxies[i].name.c_str());
 					ImGui::Text(" - id: %d", clientProxies[i].clientId);
+					ImGui::Text(" - input buffer: %u (target %u, %u underruns)",
+						clientProxies[i].inputBuffer.size(),
+						clientProxies[i].inputBuffer.targetDepth(),
+						clientProxies[i].inputBuffer.underrunCount());
 					if (clientProxies[i].gameObject != nullptr)
 					{
 						ImGui::Text(" - gameObject net id: %d", clientProxies[i].gameObject->networkId);
-						ImGui::Text(" - gameObject position: %f %f", clientProxies[i].gameObject->position.x, clientProxies[i].gameObject->position.y);
+						ImGui::Text(" - gameObject position: %f %f", clientProxies[i].gameObject->position().x, clientProxies[i].gameObject->position().y);
 					}
 					else
 					{
@@ -94,6 +104,8 @@ void ModuleNetworkingServer::onPacketReceived(const InputMemoryStream &packet, c
 {
 	if (state == ServerState::Listening)
 	{
+		if (!rateLimiter.allow(fromAddress, Time.time)) return;
+
 		uint32 protoId;
 		packet >> protoId;
 		if (protoId != PROTOCOL_ID) return;
@@ -105,6 +117,21 @@ void ModuleNetworkingServer::onPacketReceived(const InputMemoryStream &packet, c
 
 		if (message == ClientMessage::Hello)
 		{
+			uint64 challengeCookie;
+			packet >> challengeCookie;
+
+			// NOTE: Unverified addresses only get a challenge, nothing is
+			// allocated for them until they send its cookie back
+			if (proxy == nullptr && !challengeCookies.validate(challengeCookie, fromAddress, Time.time))
+			{
+				OutputMemoryStream challengePacket;
+				challengePacket << PROTOCOL_ID;
+				challengePacket << ServerMessage::Challenge;
+				challengePacket << challengeCookies.generate(fromAddress, Time.time);
+				sendPacket(challengePacket, fromAddress);
+				return;
+			}
+
 			if (proxy == nullptr)
 			{
 				proxy = createClientProxy();
@@ -122,6 +149,7 @@ void ModuleNetworkingServer::onPacketReceived(const InputMemoryStream &packet, c
 					proxy->connected = true;
 					proxy->name = playerName;
 					proxy->clientId = nextClientId++;
+					proxy->deliveryManager.stats = networkStats.addConnection(fromAddress);
 
 					// Create new network object
 					vec2 initialPosition = 1000.0f * vec2{ Random.next() - 0.5f, Random.next() - 0.5f};
@@ -175,33 +203,14 @@ void ModuleNetworkingServer::onPacketReceived(const InputMemoryStream &packet, c
 				// TODO(you): Reliability on top of UDP lab session
 
 				// Read input data
-				while (packet.RemainingByteCount() > 0)
+				InputPacketData inputs[MAX_INPUT_DATA_PER_PACKET];
+				const uint32 inputCount = readInputPacketData(packet, inputs, ArrayCount(inputs));
+				// NOTE: Buffered, they are applied one per tick in onUpdate()
+				for (uint32 i = 0; i < inputCount; ++i)
 				{
-					InputPacketData inputData;
-					packet >> inputData.sequenceNumber;
-					packet >> inputData.horizontalAxis;
-					packet >> inputData.verticalAxis;
-					packet >> inputData.buttonBits;
-					packet >> inputData.mouseX;
-					packet >> inputData.mouseY;
-					packet >> inputData.mouseButtonBits;
-
-					if (inputData.sequenceNumber >= proxy->nextExpectedInputSequenceNumber)
+					if (inputs[i].sequenceNumber >= proxy->nextExpectedInputSequenceNumber)
 					{
-						//Input
-						proxy->gamepad.horizontalAxis = inputData.horizontalAxis;
-						proxy->gamepad.verticalAxis = inputData.verticalAxis;
-						unpackInputControllerButtons(inputData.buttonBits, proxy->gamepad);
-						proxy->gameObject->behaviour->onInput(proxy->gamepad);
-
-						//Mouse
-						proxy->mouse.x = inputData.mouseX;
-						proxy->mouse.y = inputData.mouseY;
-
-						unpackMouseControllerButtons(inputData.mouseButtonBits, proxy->mouse);
-						proxy->gameObject->behaviour->onMouseInput(proxy->mouse);
-
-						proxy->nextExpectedInputSequenceNumber = inputData.sequenceNumber + 1;
+						proxy->inputBuffer.push(inputs[i]);
 					}
 				}
 			}
@@ -223,21 +232,28 @@ void ModuleNetworkingServer::onUpdate()
 	if (state == ServerState::Listening)
 	{
 		// Handle networked game object destructions
-		for (DelayedDestroyEntry &destroyEntry : netGameObjectsToDestroyWithDelay)
+		netGameObjectsToDestroyWithDelay.advance(Time.time);
+
+		uint32 gameObjectId;
+		while (netGameObjectsToDestroyWithDelay.popExpired(&gameObjectId))
+		{
+			destroyNetworkObject(&App->modGameObject->gameObjects[gameObjectId]);
+		}
+
+		for (ClientProxy &clientProxy : clientProxies)
 		{
-			if (destroyEntry.object != nullptr)
+			if (clientProxy.connected && IsValid(clientProxy.gameObject))
 			{
-				destroyEntry.delaySeconds -= Time.deltaTime;
-				if (destroyEntry.delaySeconds <= 0.0f)
-				{
-					destroyNetworkObject(destroyEntry.object);
-					destroyEntry.object = nullptr;
-				}
+				consumeInput(clientProxy);
 			}
 		}
 
 		secondsSinceSendPingPacket += Time.deltaTime;
 
+		Task *tasks[MAX_CLIENTS];
+		int taskCount = 0;
+		bool replicate = false;
+
 		for (ClientProxy &clientProxy : clientProxies)
 		{
 			if (clientProxy.connected)
@@ -258,30 +274,64 @@ void ModuleNetworkingServer::onUpdate()
 				}
 
 				// TODO(you): World state replication lab session
+				ReplicationTask &task = replicationTasks[taskCount];
+				task.clientProxy = &clientProxy;
+				task.snapshot = &replicationSnapshot;
+				task.stats = &networkStats;
+				task.replicate = false;
+
 				clientProxy.secondsSinceLastReplication += Time.deltaTime;
 				if (clientProxy.secondsSinceLastReplication >= REPLICATION_INTERVAL_SECONDS) {
-					OutputMemoryStream replicationPacket;
-					replicationPacket << PROTOCOL_ID;
-					replicationPacket.Write(ServerMessage::Replication);
-					replicationPacket << clientProxy.nextExpectedInputSequenceNumber - 1;
+					task.replicate = true;
+					replicate = true;
+					clientProxy.secondsSinceLastReplication = 0;
+				}
 
-					Delivery* delivery = clientProxy.deliveryManager.writeSequenceNumber(replicationPacket);
-					if (delivery)
-					{
-						delivery->delegate = new ReplicationDeliveryDelegate(&clientProxy.repManagerServer);
-					}
+				tasks[taskCount++] = &task;
+			}
+		}
 
-					clientProxy.repManagerServer.write(replicationPacket);
-					sendPacket(replicationPacket, clientProxy.address);
+		if (replicate)
+		{
+			PROFILE_SCOPE("Replication");
 
-					clientProxy.secondsSinceLastReplication = 0;
+			// NOTE: The world is captured once, and the packets of all
+			// proxies are built in parallel reading from the snapshot
+			const ReplicationManagerServer *managers[MAX_CLIENTS];
+			int managerCount = 0;
+			for (int i = 0; i < taskCount; ++i)
+			{
+				if (replicationTasks[i].replicate)
+				{
+					managers[managerCount++] = &replicationTasks[i].clientProxy->repManagerServer;
 				}
-				
-
-				// TODO(you): Reliability on top of UDP lab session
-				clientProxy.deliveryManager.processTimedOutPackets();
+			}
+			replicationSnapshot.capture(managers, managerCount);
+			App->modTaskManager->executeTasksAndWait(tasks, taskCount);
 
+			// Batched send of all the replication packets
+			for (int i = 0; i < taskCount; ++i)
+			{
+				ReplicationTask &task = replicationTasks[i];
+				if (task.replicate)
+				{
+					sendPacket(task.packet, task.clientProxy->address);
+				}
+			}
+		}
+		else
+		{
+			// Only timed out deliveries to process, not worth waking the workers
+			for (int i = 0; i < taskCount; ++i)
+			{
+				tasks[i]->execute();
+			}
+		}
 
+		for (ClientProxy &clientProxy : clientProxies)
+		{
+			if (clientProxy.connected)
+			{
 				clientProxy.secondsSinceLastReceivedPacket += Time.deltaTime;
 				if (clientProxy.secondsSinceLastReceivedPacket >= DISCONNECT_TIMEOUT_SECONDS) {				
 					destroyClientProxy(&clientProxy);
@@ -294,6 +344,60 @@ void ModuleNetworkingServer::onUpdate()
 	}
 }
 
+void ModuleNetworkingServer::consumeInput(ClientProxy &clientProxy)
+{
+	InputPacketData inputData;
+	if (clientProxy.inputBuffer.pop(inputData))
+	{
+		applyInput(clientProxy, inputData);
+		clientProxy.nextExpectedInputSequenceNumber = inputData.sequenceNumber + 1;
+	}
+	else if (clientProxy.inputBuffer.lastInput(inputData))
+	{
+		// Underrun, extrapolate with the last input
+		applyInput(clientProxy, inputData);
+	}
+}
+
+void ModuleNetworkingServer::applyInput(ClientProxy &clientProxy, const InputPacketData &inputData)
+{
+	//Input
+	clientProxy.gamepad.horizontalAxis = inputData.horizontalAxis;
+	clientProxy.gamepad.verticalAxis = inputData.verticalAxis;
+	unpackInputControllerButtons(inputData.buttonBits, clientProxy.gamepad);
+	clientProxy.gameObject->behaviour->onInput(clientProxy.gamepad);
+
+	//Mouse
+	clientProxy.mouse.x = inputData.mouseX;
+	clientProxy.mouse.y = inputData.mouseY;
+	unpackMouseControllerButtons(inputData.mouseButtonBits, clientProxy.mouse);
+	clientProxy.gameObject->behaviour->onMouseInput(clientProxy.mouse);
+}
+
+void ModuleNetworkingServer::ReplicationTask::execute()
+{
+	if (replicate)
+	{
+		packet.Clear();
+		packet << PROTOCOL_ID;
+		packet.Write(ServerMessage::Replication);
+		packet << clientProxy->nextExpectedInputSequenceNumber - 1;
+		// NOTE: Acks the inputs received, so the client stops resending
+		// them (applied ones are only a subset, the rest are buffered)
+		packet << clientProxy->inputBuffer.nextToReceive();
+
+		Delivery* delivery = clientProxy->deliveryManager.writeSequenceNumber(packet);
+		ReplicationDeliveryDelegate* delegate = new ReplicationDeliveryDelegate(&clientProxy->repManagerServer, &clientProxy->channels);
+		delivery->delegate = delegate;
+
+		clientProxy->channels.write(packet, delegate->channelMessages);
+		clientProxy->repManagerServer.write(packet, *snapshot, stats);
+	}
+
+	// TODO(you): Reliability on top of UDP lab session
+	clientProxy->deliveryManager.processTimedOutPackets();
+}
+
 void ModuleNetworkingServer::onConnectionReset(const sockaddr_in & fromAddress)
 {
 	// Find the client proxy
@@ -322,11 +426,7 @@ void ModuleNetworkingServer::onDisconnect()
 		destroyClientProxy(&clientProxy);
 	}
 	
-	for (DelayedDestroyEntry& destroyEntry : netGameObjectsToDestroyWithDelay)
-	{
-		destroyEntry.delaySeconds = 0.0f;
-		destroyEntry.object = nullptr;
-	}
+	netGameObjectsToDestroyWithDelay.clear(Time.time);
 
 	nextClientId = 0;
 	secondsSinceSendPingPacket = 0;
@@ -371,18 +471,12 @@ ModuleNetworkingServer::ClientProxy * ModuleNetworkingServer::getClientProxy(con
 
 void ModuleNetworkingServer::destroyClientProxy(ClientProxy *clientProxy)
 {
-	// Destroy the object from all clients
+	// Destroy the object (and its children) from all clients
 	if (IsValid(clientProxy->gameObject))
 	{
-		std::list<GameObject*> relatedNetworkObjects;
-		clientProxy->gameObject->behaviour->GetChildrenNetworkObjects(relatedNetworkObjects);
-
-		for (GameObject* networkObject : relatedNetworkObjects)
-		{
-			destroyNetworkObject(networkObject);
-		}
 		destroyNetworkObject(clientProxy->gameObject);
 	}
+	networkStats.closeConnection(clientProxy->address);
 	clientProxy->deliveryManager.clear();
     *clientProxy = {};
 }
@@ -396,9 +490,9 @@ GameObject * ModuleNetworkingServer::spawnPlayer(uint8 classType, std::string na
 {
 	// Create a new game object with the player properties
 	GameObject *gameObject = NetworkInstantiate();
-	gameObject->position = gameObject->initial_position = initialPosition;
-	gameObject->size = { 65, 65 };
-	gameObject->angle = initialAngle;
+	gameObject->position() = gameObject->initial_position() = initialPosition;
+	gameObject->size() = { 65, 65 };
+	gameObject->angle() = initialAngle;
 
 	// Create sprite
 	gameObject->sprite = App->modRender->addSprite(gameObject);
@@ -497,8 +591,35 @@ void ModuleNetworkingServer::updateNetworkObject(GameObject * gameObject)
 	}
 }
 
+void ModuleNetworkingServer::sendGameEvent(const GameEvent &event, bool reliable)
+{
+	playGameEvent(event);
+
+	OutputMemoryStream message;
+	message << ServerMessage::GameEvent;
+	event.write(message);
+
+	const ChannelType channel = reliable ? ChannelType::ReliableUnordered : ChannelType::Unreliable;
+	for (int i = 0; i < MAX_CLIENTS; ++i)
+	{
+		if (clientProxies[i].connected)
+		{
+			clientProxies[i].channels.send(channel, message);
+		}
+	}
+}
+
 void ModuleNetworkingServer::destroyNetworkObject(GameObject * gameObject)
 {
+	// Destroyed right away, drop any delayed destruction still pending
+	netGameObjectsToDestroyWithDelay.cancel(gameObject->id);
+
+	// Children go along with their parent
+	while (GameObject *child = App->modGameObject->findNetworkChild(gameObject))
+	{
+		destroyNetworkObject(child);
+	}
+
 	// Notify all client proxies' replication manager to destroy the object remotely
 	for (int i = 0; i < MAX_CLIENTS; ++i)
 	{
@@ -518,28 +639,8 @@ void ModuleNetworkingServer::destroyNetworkObject(GameObject * gameObject)
 
 void ModuleNetworkingServer::destroyNetworkObject(GameObject * gameObject, float delaySeconds)
 {
-	uint32 emptyIndex = MAX_GAME_OBJECTS;
-	for (uint32 i = 0; i < MAX_GAME_OBJECTS; ++i)
-	{
-		if (netGameObjectsToDestroyWithDelay[i].object == gameObject)
-		{
-			float currentDelaySeconds = netGameObjectsToDestroyWithDelay[i].delaySeconds;
-			netGameObjectsToDestroyWithDelay[i].delaySeconds = min(currentDelaySeconds, delaySeconds);
-			return;
-		}
-		else if (netGameObjectsToDestroyWithDelay[i].object == nullptr)
-		{
-			if (emptyIndex == MAX_GAME_OBJECTS)
-			{
-				emptyIndex = i;
-			}
-		}
-	}
-
-	ASSERT(emptyIndex < MAX_GAME_OBJECTS);
-
-	netGameObjectsToDestroyWithDelay[emptyIndex].object = gameObject;
-	netGameObjectsToDestroyWithDelay[emptyIndex].delaySeconds = delaySeconds;
+	// NOTE: If the object was already scheduled, the earliest time is kept
+	netGameObjectsToDestroyWithDelay.schedule(gameObject->id, Time.time + delaySeconds);
 }
 
 
@@ -584,3 +685,10 @@ void NetworkDestroy(GameObject * gameObject, float delaySeconds)
 	App->modNetServer->destroyNetworkObject(gameObject, delaySeconds);
 }
 
+void NetworkEvent(const GameEvent &event, bool reliable)
+{
+	ASSERT(App->modNetServer->isConnected());
+
+	App->modNetServer->sendGameEvent(event, reliable);
+}
+
@@ -59,8 +59,10 @@ private:
 		float secondsSinceLastReplication = 0;
 		// TODO(you): Reliability on top of UDP lab session
 		DeliveryManager deliveryManager;
+		MessageChannelSender channels;
 
-		uint32 nextExpectedInputSequenceNumber = 0;
+		uint32 nextExpectedInputSequenceNumber = 0; // Next input to consume
+		InputBuffer inputBuffer;
 		InputController gamepad;
 		MouseController mouse;
 	};
@@ -73,6 +75,34 @@ private:
 
     void destroyClientProxy(ClientProxy *clientProxy);
 
+	// Feeds the player of a proxy with one input per tick
+	void consumeInput(ClientProxy &clientProxy);
+	void applyInput(ClientProxy &clientProxy, const InputPacketData &inputData);
+
+
+
+	//////////////////////////////////////////////////////////////////////
+	// Replication
+	//////////////////////////////////////////////////////////////////////
+
+	// Delivery bookkeeping and replication packet of one client proxy,
+	// executed by the task manager workers
+	class ReplicationTask : public Task
+	{
+	public:
+
+		void execute() override;
+
+		ClientProxy *clientProxy = nullptr;
+		const ReplicationSnapshot *snapshot = nullptr;
+		NetworkStats *stats = nullptr;
+		bool replicate = false;
+		OutputMemoryStream packet;
+	};
+
+	ReplicationSnapshot replicationSnapshot;
+	ReplicationTask replicationTasks[MAX_CLIENTS];
+
 
 
 public:
@@ -104,13 +134,11 @@ private:
 	friend void (NetworkDestroy)(GameObject *);
 	friend void (NetworkDestroy)(GameObject *, float delaySeconds);
 
-	struct DelayedDestroyEntry
-	{
-		float delaySeconds = 0.0f;
-		GameObject *object = nullptr;
-	};
+	void sendGameEvent(const GameEvent &event, bool reliable);
+	friend void (NetworkEvent)(const GameEvent &, bool reliable);
 
-	DelayedDestroyEntry netGameObjectsToDestroyWithDelay[MAX_GAME_OBJECTS] = {};
+	// Pending delayed destructions, keyed by game object id
+	TimerWheel netGameObjectsToDestroyWithDelay;
 
 
 
@@ -128,6 +156,9 @@ private:
 
 	uint16 listenPort = 0;
 
+	ChallengeCookies challengeCookies;
+	RateLimiter rateLimiter;
+
 
 
 	// TODO(you): UDP virtual connection lab session
@@ -153,3 +184,7 @@ void NetworkUpdate(GameObject *gameObject);
 // machines.
 void NetworkDestroy(GameObject *gameObject);
 void NetworkDestroy(GameObject *gameObject, float delaySeconds);
+
+// NOTE: Plays a one-shot game event (see GameEvents.h) on the server and
+// sends it to all connected clients, instead of replicating an object.
+void NetworkEvent(const GameEvent &event, bool reliable = false);
@@ -28,22 +28,6 @@ static ID3D11BlendState*        g_pBlendState = NULL;
 static ID3D11DepthStencilState* g_pDepthStencilState = NULL;
 static ID3D11SamplerState*      g_pTextureSampler = NULL;
 
-struct CUSTOMVERTEX
-{
-	FLOAT x, y;
-	FLOAT u, v;
-};
-
-CUSTOMVERTEX defaultSpriteRect[] =
-{
-	{ -0.5f, -0.5f,    0.f, 0.f, },
-	{ -0.5f,  0.5f,    0.f, 1.f, },
-	{  0.5f,  0.5f,    1.f, 1.f, },
-	{ -0.5f, -0.5f,    0.f, 0.f, },
-	{  0.5f,  0.5f,    1.f, 1.f, },
-	{  0.5f, -0.5f,    1.f, 0.f, },
-};
-
 struct CONSTANT_BUFFER
 {
 	float ProjectionMatrix[4][4];
@@ -111,9 +95,10 @@ bool ModuleRender::init()
 	//	return false;
 	//}
 
+	// NOTE: Big enough for all the vertices of a full sprite batch
 	D3D11_BUFFER_DESC desc = {};
 	desc.Usage = D3D11_USAGE_DYNAMIC;
-	desc.ByteWidth = sizeof(defaultSpriteRect);
+	desc.ByteWidth = sizeof(SpriteVertex) * SpriteBatch::MAX_VERTICES;
 	desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
 	desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
 
@@ -158,12 +143,13 @@ bool ModuleRender::init()
 	// Create the input layout
 	D3D11_INPUT_ELEMENT_DESC local_layout[] =
 	{
-		{ "POSITION", 0, DXGI_FORMAT_R32G32_FLOAT,   0, (size_t)(&((CUSTOMVERTEX*)0)->x), D3D11_INPUT_PER_VERTEX_DATA, 0 },
-		{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT,   0, (size_t)(&((CUSTOMVERTEX*)0)->u), D3D11_INPUT_PER_VERTEX_DATA, 0 },
+		{ "POSITION", 0, DXGI_FORMAT_R32G32_FLOAT,       0, (size_t)(&((SpriteVertex*)0)->x), D3D11_INPUT_PER_VERTEX_DATA, 0 },
+		{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT,       0, (size_t)(&((SpriteVertex*)0)->u), D3D11_INPUT_PER_VERTEX_DATA, 0 },
+		{ "COLOR",    0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, (size_t)(&((SpriteVertex*)0)->r), D3D11_INPUT_PER_VERTEX_DATA, 0 },
 	};
 	if (g_pd3dDevice->CreateInputLayout(
 		local_layout,
-		2,
+		3,
 		g_pVertexShaderBlob->GetBufferPointer(),
 		g_pVertexShaderBlob->GetBufferSize(),
 		&g_pInputLayout) != S_OK) {
@@ -342,7 +328,7 @@ bool ModuleRender::update()
 
 bool ModuleRender::postUpdate()
 {
-	BEGIN_TIMED_BLOCK(Render);
+	PROFILE_SCOPE("Render");
 
 	//float clear_color[] = { 0.45f, 0.55f, 0.60f, 1.00f };
 	float clear_color[] = { 0.f, 0.f, 0.f, 1.f };
@@ -350,8 +336,6 @@ bool ModuleRender::postUpdate()
 	g_pd3dDeviceContext->ClearRenderTargetView(g_mainRenderTargetView, (float*)&clear_color);
 
 	renderScene();
-
-	END_TIMED_BLOCK(Render);
 	return true;
 }
 
@@ -394,6 +378,7 @@ Animation * ModuleRender::addAnimation(GameObject * parent)
 	ASSERT(animations[parent->id].gameObject == nullptr);
 	Animation *animation = &animations[parent->id];
 	animation->gameObject = parent;
+	animation->lastUpdateTime = Time.time;
 	animationCount++;
 	return animation;
 }
@@ -493,72 +478,201 @@ void ModuleRender::present()
 	//g_pSwapChain->Present(0, 0); // Present without vsync
 }
 
-static int partition(GameObject **objects, int begin, int end)
+static vec2 spriteSize(GameObject *gameObject)
+{
+	vec2 textureSize = gameObject->sprite->texture ? gameObject->sprite->texture->size : vec2{ 100.0f, 100.0f };
+	return vec2{
+		gameObject->size().x == 0.0f ? textureSize.x : gameObject->size().x,
+		gameObject->size().y == 0.0f ? textureSize.y : gameObject->size().y };
+}
+
+static bool isSpriteInView(GameObject *gameObject, vec2 viewMin, vec2 viewMax)
+{
+	// Axis aligned bounds of the rotated sprite rect
+	const vec2 size = spriteSize(gameObject);
+	const vec2 pivot = gameObject->sprite->pivot;
+	const float radians = radiansFromDegrees(gameObject->angle());
+	const float c = cosf(radians);
+	const float s = sinf(radians);
+	const vec2 offset = vec2{ (0.5f - pivot.x) * size.x, (0.5f - pivot.y) * size.y };
+	const vec2 center = gameObject->position() + vec2{ offset.x * c - offset.y * s, offset.x * s + offset.y * c };
+	const float extentX = 0.5f * (fabsf(c * size.x) + fabsf(s * size.y));
+	const float extentY = 0.5f * (fabsf(s * size.x) + fabsf(c * size.y));
+
+	return center.x + extentX >= viewMin.x && center.x - extentX <= viewMax.x &&
+		center.y + extentY >= viewMin.y && center.y - extentY <= viewMax.y;
+}
+
+static inline int cullCellCoord(float worldCoord, float cellSize)
+{
+	return (int)floorf(worldCoord / cellSize);
+}
+
+void ModuleRender::selectAndSortObjects(vec2 viewMin, vec2 viewMax, GameObject *result[MAX_GAME_OBJECTS], int *numElems)
 {
-	GameObject *tmp = nullptr;
-	int pivot = objects[end]->sprite->order;
-	int pi = begin;
+	PROFILE_FUNCTION();
 
-	for (int i = begin; i < end; ++i)
+	ModuleGameObject *modGameObject = App->modGameObject;
+
+	const uint32 cellMask = CULL_GRID_CELLS - 1;
+	static_assert((CULL_GRID_CELLS & (CULL_GRID_CELLS - 1)) == 0, "CULL_GRID_CELLS must be a power of two");
+
+	// Bucket the sprites by cell. This pass only reads positions and sizes,
+	// the expensive per-sprite work is left for the ones in view.
+	uint32 cellCounts[CULL_GRID_CELLS * CULL_GRID_CELLS] = {};
+	uint32 candidateCount = 0;
+	uint32 largeObjectCount = 0;
+
+	for (uint32 i = 0; i < modGameObject->activeGameObjectCount; ++i)
 	{
-		if (objects[i]->sprite->order < pivot)
+		GameObject &gameObject = modGameObject->gameObjects[modGameObject->activeGameObjectIndices[i]];
+		if (gameObject.state != GameObject::UPDATING ||
+			gameObject.sprite == nullptr ||
+			!gameObject.sprite->enabled)
 		{
-			tmp = objects[i];
-			objects[i] = objects[pi];
-			objects[pi] = tmp;
-			pi++;
+			continue;
 		}
-	}
 
-	tmp = objects[end];
-	objects[end] = objects[pi];
-	objects[pi] = tmp;
+		// Conservative distance from the position to any corner, for any rotation
+		const vec2 size = spriteSize(&gameObject);
+		const vec2 pivot = gameObject.sprite->pivot;
+		const float reach =
+			(fabsf(0.5f - pivot.x) + 0.5f) * fabsf(size.x) +
+			(fabsf(0.5f - pivot.y) + 0.5f) * fabsf(size.y);
 
-	return pi;
-}
+		if (reach > CULL_CELL_SIZE)
+		{
+			cullLargeObjects[largeObjectCount++] = (uint16)gameObject.id;
+			continue;
+		}
 
-static void quicksort(GameObject **objects, int begin, int end)
-{
-	if (begin < end)
+		const vec2 position = gameObject.position();
+		const uint32 cellX = (uint32)cullCellCoord(position.x, CULL_CELL_SIZE) & cellMask;
+		const uint32 cellY = (uint32)cullCellCoord(position.y, CULL_CELL_SIZE) & cellMask;
+		const uint32 cell = cellY * CULL_GRID_CELLS + cellX;
+
+		cullCandidates[candidateCount] = (uint16)gameObject.id;
+		cullCandidateCells[candidateCount] = (uint16)cell;
+		candidateCount++;
+		cellCounts[cell]++;
+	}
+
+	uint32 sum = 0;
+	for (uint32 cell = 0; cell < CULL_GRID_CELLS * CULL_GRID_CELLS; ++cell)
 	{
-		int pi = partition(objects, begin, end);
-		quicksort(objects, begin, pi - 1);
-		quicksort(objects, pi + 1, end);
+		cullCellStart[cell] = (uint16)sum;
+		sum += cellCounts[cell];
+		cellCounts[cell] = cullCellStart[cell];
 	}
-}
+	cullCellStart[CULL_GRID_CELLS * CULL_GRID_CELLS] = (uint16)sum;
 
-static bool needsSorting(GameObject *objects[MAX_GAME_OBJECTS], int numElems)
-{
-	for (int i = 0; i < numElems - 1; ++i)
+	for (uint32 i = 0; i < candidateCount; ++i)
+	{
+		cullCellObjects[cellCounts[cullCandidateCells[i]]++] = cullCandidates[i];
+	}
+
+	// NOTE: Sort key packed as (order, texture, id). The id makes the sort
+	// deterministic between frames, and the texture keeps sprites of the
+	// same order next to each other when they can share a draw call.
+	//   bits 32..63: order (sign bit flipped so that negatives go first)
+	//   bits 16..31: texture index
+	//   bits  0..15: game object id
+	static_assert(MAX_GAME_OBJECTS <= 0x10000 && MAX_TEXTURES <= 0x10000, "Sort key fields too small");
+
+	uint32 keyCount = 0;
+	auto addIfVisible = [&](uint16 id)
 	{
-		if (objects[i]->sprite->order > objects[i + 1]->sprite->order)
+		GameObject &gameObject = modGameObject->gameObjects[id];
+		if (!isSpriteInView(&gameObject, viewMin, viewMax))
 		{
-			return true;
+			return;
+		}
+
+		if (gameObject.animation != nullptr)
+		{
+			gameObject.animation->update(Time.time);
+			if (gameObject.animation->finished())
+			{
+				return;
+			}
+		}
+
+		Texture *texture = gameObject.sprite->texture ? gameObject.sprite->texture : whitePixel;
+		if (texture->atlasPage != nullptr) texture = texture->atlasPage;
+		uint64 order = (uint32)gameObject.sprite->order ^ 0x80000000;
+		uint64 textureIndex = App->modTextures->getTextureIndex(texture);
+		sortKeys[keyCount++] = (order << 32) | (textureIndex << 16) | gameObject.id;
+	};
+
+	// Visit the cells overlapping the view, grown by one cell since sprites
+	// can reach up to CULL_CELL_SIZE beyond the cell of their position
+	const int minCellX = cullCellCoord(viewMin.x, CULL_CELL_SIZE) - 1;
+	const int minCellY = cullCellCoord(viewMin.y, CULL_CELL_SIZE) - 1;
+	const int cellCountX = min(cullCellCoord(viewMax.x, CULL_CELL_SIZE) + 1 - minCellX + 1, (int)CULL_GRID_CELLS);
+	const int cellCountY = min(cullCellCoord(viewMax.y, CULL_CELL_SIZE) + 1 - minCellY + 1, (int)CULL_GRID_CELLS);
+
+	for (int y = 0; y < cellCountY; ++y)
+	{
+		for (int x = 0; x < cellCountX; ++x)
+		{
+			const uint32 cellX = (uint32)(minCellX + x) & cellMask;
+			const uint32 cellY = (uint32)(minCellY + y) & cellMask;
+			const uint32 cell = cellY * CULL_GRID_CELLS + cellX;
+
+			for (uint32 i = cullCellStart[cell]; i < cullCellStart[cell + 1]; ++i)
+			{
+				addIfVisible(cullCellObjects[i]);
+			}
 		}
 	}
-	return false;
-}
 
-static void selectAndSortObjects(GameObject toSort[MAX_GAME_OBJECTS], GameObject *result[MAX_GAME_OBJECTS], int *numElems)
-{
-	*numElems = 0;
-	for (int i = 0; i < MAX_GAME_OBJECTS; ++i)
-	{
-		if (toSort[i].state == GameObject::UPDATING &&
-			toSort[i].sprite != nullptr && 
-			toSort[i].sprite->enabled &&
-			(toSort[i].animation == nullptr ||
-			!toSort[i].animation->finished())) // && toSort[i]->scene->enabled)
+	for (uint32 i = 0; i < largeObjectCount; ++i)
+	{
+		addIfVisible(cullLargeObjects[i]);
+	}
+
+	// LSD radix sort, 8 bits per pass, linear regardless of how many
+	// sprites share the same order. Passes where all the keys fall in
+	// the same bucket (e.g. all orders in a small range) are skipped.
+	uint64 *keys = sortKeys;
+	uint64 *temp = sortKeysTemp;
+	for (uint32 shift = 0; shift < 64; shift += 8)
+	{
+		uint32 offsets[256] = {};
+		for (uint32 i = 0; i < keyCount; ++i)
+		{
+			offsets[(keys[i] >> shift) & 0xff]++;
+		}
+
+		if (keyCount == 0 || offsets[(keys[0] >> shift) & 0xff] == keyCount)
 		{
-			result[*numElems] = &toSort[i];
-			(*numElems)++;
+			continue;
 		}
+
+		uint32 sum = 0;
+		for (uint32 &offset : offsets)
+		{
+			uint32 count = offset;
+			offset = sum;
+			sum += count;
+		}
+
+		for (uint32 i = 0; i < keyCount; ++i)
+		{
+			temp[offsets[(keys[i] >> shift) & 0xff]++] = keys[i];
+		}
+
+		uint64 *swap = keys;
+		keys = temp;
+		temp = swap;
 	}
 
-	if (needsSorting(result, *numElems))
+	for (uint32 i = 0; i < keyCount; ++i)
 	{
-		quicksort(result, 0, *numElems - 1);
+		result[i] = &modGameObject->gameObjects[keys[i] & 0xffff];
 	}
+
+	*numElems = (int)keyCount;
 }
 
 void ModuleRender::renderScene()
@@ -581,7 +695,7 @@ void ModuleRender::renderScene()
 	ctx->RSSetViewports(1, &vp);
 
 	// Setup shader and vertex buffers
-	unsigned int stride = sizeof(CUSTOMVERTEX);
+	unsigned int stride = sizeof(SpriteVertex);
 	unsigned int offset = 0;
 	ctx->IASetInputLayout(g_pInputLayout);
 	ctx->IASetVertexBuffers(0, 1, &g_pVertexBuffer, &stride, &offset);
@@ -612,134 +726,106 @@ void ModuleRender::renderScene()
 	// View matrix
 	XMMATRIX ViewMatrix = ::XMMatrixTranslation(-cameraPosition.x, -cameraPosition.y, 0.0f);
 
-	// Render game objects
+	// Camera view in world coordinates
+	const vec2 viewMin = cameraPosition + vec2{ L, T };
+	const vec2 viewMax = cameraPosition + vec2{ R, B };
+
+	// Build the sprite batch
 	int numObjects = 0;
-	selectAndSortObjects(App->modGameObject->gameObjects, orderedGameObjects, &numObjects);
+	selectAndSortObjects(viewMin, viewMax, orderedGameObjects, &numObjects);
+
+	spriteBatch.begin();
 
 	for (int i = 0; i < numObjects; ++i)
 	{
 		GameObject *gameObject = orderedGameObjects[i];
-		
-		// Upload vertices
-		D3D11_MAPPED_SUBRESOURCE mapped_vertices;
-		if (ctx->Map(g_pVertexBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped_vertices) != S_OK) {
-			WLOG("d3d->Map() failed (VERTEX BUFFER)");
-			return;
-		}
-		if (gameObject->animation == nullptr)
+
+		Texture *texture = gameObject->sprite->texture ? gameObject->sprite->texture : whitePixel;
+
+		// NOTE: Animations were already updated when selected
+		vec4 uvRect = texture->uvRect;
+		if (gameObject->animation != nullptr)
 		{
-			memcpy(mapped_vertices.pData, (void*)defaultSpriteRect, sizeof(defaultSpriteRect));
+			// Frame rects are relative to the texture, which may be an atlas region
+			vec4 frameRect = gameObject->animation->currentFrameRect();
+			uvRect = vec4{
+				uvRect.x + frameRect.x * uvRect.z,
+				uvRect.y + frameRect.y * uvRect.w,
+				frameRect.z * uvRect.z,
+				frameRect.w * uvRect.w };
 		}
-		else
+
+		vec2 size = spriteSize(gameObject);
+
+		if (texture->atlasPage != nullptr)
 		{
-			gameObject->animation->update(Time.deltaTime);
-			vec4 rect = gameObject->animation->currentFrameRect();
-			const float u0 = rect.x;
-			const float u1 = rect.x + rect.z;
-			const float v0 = rect.y;
-			const float v1 = rect.y + rect.w;
-			CUSTOMVERTEX *vertex_buffer = (CUSTOMVERTEX*)mapped_vertices.pData;
-			vertex_buffer[0] = { -0.5f, -0.5f, u0, v0 };
-			vertex_buffer[1] = { -0.5f,  0.5f, u0, v1 };
-			vertex_buffer[2] = { 0.5f,  0.5f, u1, v1 };
-			vertex_buffer[3] = { -0.5f, -0.5f, u0, v0 };
-			vertex_buffer[4] = { 0.5f,  0.5f, u1, v1 };
-			vertex_buffer[5] = { 0.5f, -0.5f, u1, v0 };
+			texture = texture->atlasPage;
 		}
-		ctx->Unmap(g_pVertexBuffer, 0);
 
-		// Setup matrices into our constant buffer
+		spriteBatch.addSprite(texture, gameObject->position(), size, gameObject->sprite->pivot,
+			gameObject->angle(), uvRect, gameObject->sprite->color);
+	}
+
+	// Colliders
+	if (mustRenderColliders)
+	{
+		const vec4 colliderColor = vec4{ 1.0f, 0.0f, 0.0f, 0.4f };
+
+		for (uint32 i = 0; i < MAX_COLLIDERS; ++i)
 		{
-			// World matrix
-			vec2 textureSize = gameObject->sprite->texture ? gameObject->sprite->texture->size : vec2{ 100.0f, 100.0f };
-			vec2 size = vec2{
-				gameObject->size.x == 0.0f ? textureSize.x : gameObject->size.x,
-				gameObject->size.y == 0.0f ? textureSize.y : gameObject->size.y };
-			XMMATRIX WorldMatrix =
-				::XMMatrixTranslation(0.5f - gameObject->sprite->pivot.x,
-					0.5f - gameObject->sprite->pivot.y,
-					0.0f) *
-				::XMMatrixScaling(size.x, size.y, 1.0f) *
-				::XMMatrixRotationZ(::XMConvertToRadians(gameObject->angle)) *
-				::XMMatrixTranslation(gameObject->position.x,gameObject->position.y, 0.0f);
-
-			// Copy matrices into the constant buffer
-			D3D11_MAPPED_SUBRESOURCE mapped_resource;
-			if (ctx->Map(g_pConstantBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped_resource) != S_OK) {
-				WLOG("d3d->Map() failed (CONSTANT BUFFER)");
-				return;
-			}
-			CONSTANT_BUFFER* constant_buffer = (CONSTANT_BUFFER*)mapped_resource.pData;
-			memcpy(&constant_buffer->ProjectionMatrix, &ProjectionMatrix, sizeof(ProjectionMatrix));
-			memcpy(&constant_buffer->ViewMatrix, &ViewMatrix, sizeof(ViewMatrix));
-			memcpy(&constant_buffer->WorldMatrix, &WorldMatrix, sizeof(WorldMatrix));
-			memcpy(&constant_buffer->TintColor, gameObject->sprite->color.coords, sizeof(gameObject->sprite->color.coords));
-			ctx->Unmap(g_pConstantBuffer, 0);
+			Collider *collider = &App->modCollision->colliders[i];
+			GameObject *gameObject = collider->gameObject;
+			if (collider->type == ColliderType::None || gameObject == nullptr) continue;
+
+			vec2 size = spriteSize(gameObject);
+
+			spriteBatch.addSprite(whitePixel, gameObject->position(), size, gameObject->sprite->pivot,
+				gameObject->angle(), vec4{ 0.0f, 0.0f, 1.0f, 1.0f }, colliderColor);
 		}
-		
-		// Pass texture to shader
-		Texture *texture = gameObject->sprite->texture ? gameObject->sprite->texture : whitePixel;
-		ID3D11ShaderResourceView* texture_srv = (ID3D11ShaderResourceView*)texture->shaderResource;
-		ctx->PSSetShaderResources(0, 1, &texture_srv);
+	}
 
-		ctx->Draw(6, 0);
+	if (spriteBatch.getVertexCount() == 0)
+	{
+		return;
 	}
 
-	// Render colliders
-	if (mustRenderColliders)
+	// Upload all the vertices at once
 	{
-		// Upload vertices
 		D3D11_MAPPED_SUBRESOURCE mapped_vertices;
 		if (ctx->Map(g_pVertexBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped_vertices) != S_OK) {
 			WLOG("d3d->Map() failed (VERTEX BUFFER)");
 			return;
 		}
-		memcpy(mapped_vertices.pData, (void*)defaultSpriteRect, sizeof(defaultSpriteRect));
+		memcpy(mapped_vertices.pData, spriteBatch.getVertices(), sizeof(SpriteVertex) * spriteBatch.getVertexCount());
 		ctx->Unmap(g_pVertexBuffer, 0);
+	}
 
-		// Pass texture to shader
-		Texture *texture = whitePixel;
-		ID3D11ShaderResourceView* texture_srv = (ID3D11ShaderResourceView*)texture->shaderResource;
-		ctx->PSSetShaderResources(0, 1, &texture_srv);
+	// Setup matrices into our constant buffer (vertices are already in world space)
+	{
+		XMMATRIX WorldMatrix = ::XMMatrixIdentity();
+		vec4 tintColor = vec4{ 1.0f, 1.0f, 1.0f, 1.0f };
 
-		for (uint32 i = 0; i < MAX_COLLIDERS; ++i)
-		{
-			Collider *collider = &App->modCollision->colliders[i];
-			GameObject *gameObject = collider->gameObject;
-			if (collider->type == ColliderType::None || gameObject == nullptr) continue;
+		D3D11_MAPPED_SUBRESOURCE mapped_resource;
+		if (ctx->Map(g_pConstantBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped_resource) != S_OK) {
+			WLOG("d3d->Map() failed (CONSTANT BUFFER)");
+			return;
+		}
+		CONSTANT_BUFFER* constant_buffer = (CONSTANT_BUFFER*)mapped_resource.pData;
+		memcpy(&constant_buffer->ProjectionMatrix, &ProjectionMatrix, sizeof(ProjectionMatrix));
+		memcpy(&constant_buffer->ViewMatrix, &ViewMatrix, sizeof(ViewMatrix));
+		memcpy(&constant_buffer->WorldMatrix, &WorldMatrix, sizeof(WorldMatrix));
+		memcpy(&constant_buffer->TintColor, tintColor.coords, sizeof(tintColor.coords));
+		ctx->Unmap(g_pConstantBuffer, 0);
+	}
 
-			// Setup matrices into our constant buffer
-			{
-				// World matrix
-				vec2 textureSize = gameObject->sprite->texture ? gameObject->sprite->texture->size : vec2{ 100.0f, 100.0f };
-				vec2 size = vec2{
-					gameObject->size.x == 0.0f ? textureSize.x : gameObject->size.x,
-					gameObject->size.y == 0.0f ? textureSize.y : gameObject->size.y };
-				XMMATRIX WorldMatrix =
-					::XMMatrixTranslation(0.5f - gameObject->sprite->pivot.x,
-						0.5f - gameObject->sprite->pivot.y,
-						0.0f) *
-					::XMMatrixScaling(size.x, size.y, 1.0f) *
-					::XMMatrixRotationZ(::XMConvertToRadians(gameObject->angle)) *
-					::XMMatrixTranslation(gameObject->position.x, gameObject->position.y, 0.0f);
-
-				// Copy matrices into the constant buffer
-				D3D11_MAPPED_SUBRESOURCE mapped_resource;
-				if (ctx->Map(g_pConstantBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped_resource) != S_OK) {
-					WLOG("d3d->Map() failed (CONSTANT BUFFER)");
-					return;
-				}
-				CONSTANT_BUFFER* constant_buffer = (CONSTANT_BUFFER*)mapped_resource.pData;
-				memcpy(&constant_buffer->ProjectionMatrix, &ProjectionMatrix, sizeof(ProjectionMatrix));
-				memcpy(&constant_buffer->ViewMatrix, &ViewMatrix, sizeof(ViewMatrix));
-				memcpy(&constant_buffer->WorldMatrix, &WorldMatrix, sizeof(WorldMatrix));
-				vec4 colliderColor = vec4{ 1.0f, 0.0f, 0.0f, 0.4f };
-				memcpy(&constant_buffer->TintColor, &colliderColor, sizeof(colliderColor));
-				ctx->Unmap(g_pConstantBuffer, 0);
-			}
+	// One draw call per texture run
+	const SpriteBatchRun *runs = spriteBatch.getRuns();
+	for (uint32 i = 0; i < spriteBatch.getRunCount(); ++i)
+	{
+		ID3D11ShaderResourceView* texture_srv = (ID3D11ShaderResourceView*)runs[i].texture->shaderResource;
+		ctx->PSSetShaderResources(0, 1, &texture_srv);
 
-			ctx->Draw(6, 0);
-		}
+		ctx->Draw(runs[i].vertexCount, runs[i].firstVertex);
 	}
 }
 
@@ -832,6 +918,9 @@ void Sprite::read(const InputMemoryStream& packet)
 
 void Animation::write(OutputMemoryStream& packet)
 {
+	// Bring the elapsed time up to date, it may be out of view
+	update(Time.time);
+
 	packet.Write(clip->id);
 	packet.Write(elapsedTime);
 	packet.Write(currentFrame);
@@ -845,4 +934,5 @@ void Animation::read(const InputMemoryStream& packet)
 
 	packet.Read(elapsedTime);
 	packet.Read(currentFrame);
+	lastUpdateTime = Time.time;
 }
@@ -38,23 +38,31 @@ struct Animation
 	float elapsedTime = 0.0f;
 	uint8 currentFrame = 0;
 
-	void update(float deltaTime)
+	// NOTE: Animations advance on update() by the time passed since the
+	// previous call, which starts when they are added. Objects out of the
+	// camera view are not updated, and catch up once they become visible
+	// again (or when they are replicated).
+	double lastUpdateTime = 0.0;
+
+	void update(double time)
 	{
-		elapsedTime = elapsedTime + deltaTime;
-		currentFrame = (uint8)min(clip->frameCount - 1, elapsedTime / clip->frameTime);
+		elapsedTime = elapsedTime + (float)(time - lastUpdateTime);
+		lastUpdateTime = time;
 
 		float duration = clip->frameCount * clip->frameTime;
-		while (clip->loop && elapsedTime > duration)
+		if (clip->loop && elapsedTime > duration && duration > 0.0f)
 		{
-			elapsedTime -= duration;
-			currentFrame = 0;
+			elapsedTime = fmodf(elapsedTime, duration);
 		}
+
+		currentFrame = (uint8)min(clip->frameCount - 1, elapsedTime / clip->frameTime);
 	}
 
 	void rewind()
 	{
 		elapsedTime = 0.0f;
 		currentFrame = 0;
+		lastUpdateTime = Time.time;
 	}
 
 	vec4 currentFrameRect() const
@@ -122,6 +130,8 @@ private:
 
 	void renderScene();
 
+	void selectAndSortObjects(vec2 viewMin, vec2 viewMax, GameObject *result[MAX_GAME_OBJECTS], int *numElems);
+
 	bool CreateDeviceD3D(HWND hWnd);
 	void CleanupDeviceD3D();
 	void CreateRenderTarget();
@@ -131,6 +141,21 @@ private:
 	Texture * blackPixel = nullptr;
 
 	GameObject* orderedGameObjects[MAX_GAME_OBJECTS] = {};
+	uint64 sortKeys[MAX_GAME_OBJECTS] = {};
+	uint64 sortKeysTemp[MAX_GAME_OBJECTS] = {};
+
+	// Culling grid. Sprites are bucketed by the cell of their position
+	// (cells wrap around the grid) so that only the buckets around the
+	// camera view are visited. Sprites larger than a cell are kept apart.
+	static const uint32 CULL_GRID_CELLS = 64;
+	static constexpr float CULL_CELL_SIZE = 256.0f;
+	uint16 cullCellStart[CULL_GRID_CELLS * CULL_GRID_CELLS + 1] = {};
+	uint16 cullCellObjects[MAX_GAME_OBJECTS] = {};
+	uint16 cullCandidates[MAX_GAME_OBJECTS] = {};
+	uint16 cullCandidateCells[MAX_GAME_OBJECTS] = {};
+	uint16 cullLargeObjects[MAX_GAME_OBJECTS] = {};
+
+	SpriteBatch spriteBatch;
 
 	uint8 shaderSource[Kilobytes(128)];
 
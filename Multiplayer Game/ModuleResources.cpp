@@ -2,11 +2,28 @@
 #include "ModuleResources.h"
 
 
+static const char *ATLAS_CACHE_FILENAME = "sprites.atlas";
+
 #if defined(USE_TASK_MANAGER)
 
-void ModuleResources::TaskLoadTexture::execute()
+void ModuleResources::TaskHashSource::execute()
+{
+	hashSource(*resource);
+}
+
+void ModuleResources::TaskDecodeImage::execute()
 {
-	*texture = App->modTextures->loadTexture(filename);
+	decodeImage(*resource);
+}
+
+void ModuleResources::TaskLoadAtlasCache::execute()
+{
+	valid = resources->validateAtlasCache();
+}
+
+void ModuleResources::TaskBuildAtlas::execute()
+{
+	built = resources->buildAtlas();
 }
 
 #endif
@@ -33,142 +50,316 @@ Texture* ModuleResources::GetTextureByFile(std::string fileName)
 	else if (fileName == "iceSpike.png") return iceSpike;
 	
 }
+float ModuleResources::loadingProgress() const
+{
+	if (loadingStepCount == 0) return 1.0f;
+	return (float)finishedLoadingStepCount / (float)loadingStepCount;
+}
+
 bool ModuleResources::init()
 {
+	loadingStartTime = std::chrono::steady_clock::now();
+
+	// Everything the main menu needs
 	background = App->modTextures->loadTexture("background.jpg");
+	audioClipDeath = App->modSound->loadAudioClip("death.wav");
+
+	// NOTE: Frame rects are relative to the texture, the clips don't have
+	// to wait for any of them to be loaded
+	createAnimationClips();
+
+	menuResourcesLoaded = true;
+
+	addTextureResource("arena.png",           &grass);
+	addTextureResource("death_animation.png", &death);
+	addTextureResource("berserker_idle.png",  &berserkerIdle);
+	addTextureResource("berserker_run.png",   &berserkerRun);
+	addTextureResource("wizard_idle.png",     &wizardIdle);
+	addTextureResource("wizard_run.png",      &wizardRun);
+	addTextureResource("hunter_idle.png",     &hunterIdle);
+	addTextureResource("hunter_run.png",      &hunterRun);
+	addTextureResource("Waraxe.png",          &axe);
+	addTextureResource("Staff.png",           &staff);
+	addTextureResource("Bow.png",             &bow);
+	addTextureResource("Waraxe_p.png",        &axeProjectile);
+	addTextureResource("Staff_p.png",         &staffProjectile);
+	addTextureResource("Bow_p.png",           &bowProjectile);
+	addTextureResource("chargeEffect.png",    &chargeEffect);
+	addTextureResource("iceSpike.png",        &iceSpike);
+
+	// Hash and decode each texture, then build and upload the atlas
+	loadingStepCount = 2 * textureResourceCount + 2;
 
 #if !defined(USE_TASK_MANAGER)
-	grass = App->modTextures->loadTexture("arena.jpg");
-	death = App->modTextures->loadTexture("death_animation.png");
-	berserkerIdle = App->modTextures->loadTexture("berserker_idle.png");
-	berserkerRun = App->modTextures->loadTexture("berserker_run.png");
-	wizardIdle = App->modTextures->loadTexture("wizard_idle.png");
-	wizardRun = App->modTextures->loadTexture("wizard_run.png");
-	hunterIdle = App->modTextures->loadTexture("hunter_idle.png");
-	hunterRun = App->modTextures->loadTexture("hunter_run.png");
-	axe = App->modTextures->loadTexture("Waraxe.png");
-	staff = App->modTextures->loadTexture("Staff.png");
-	bow = App->modTextures->loadTexture("Bow.png");
-	axeProjectile = App->modTextures->loadTexture("Waraxe_p.png");
-	staffProjectile = App->modTextures->loadTexture("Staff_p.png");
-	bowProjectile = App->modTextures->loadTexture("Bow_p.png");
-	chargeEffect = App->modTextures->loadTexture("chargeEffect.png");
-	iceSpike = App->modTextures->loadTexture("iceSpike.png");
-
-	loadingFinished = true;
-	completionRatio = 1.0f;
+	for (uint32 i = 0; i < textureResourceCount; ++i)
+	{
+		hashSource(textureResources[i]);
+		finishedLoadingStepCount++;
+	}
+
+	if (validateAtlasCache())
+	{
+		loadedFromCache = true;
+		finishedLoadingStepCount += textureResourceCount + 1;
+		finishLoading(true);
+	}
+	else
+	{
+		for (uint32 i = 0; i < textureResourceCount; ++i)
+		{
+			decodeImage(textureResources[i]);
+			finishedLoadingStepCount++;
+		}
+
+		finishLoading(buildAtlas());
+	}
 #else
-	loadTextureAsync("arena.png",			 &grass);
-	loadTextureAsync("death_animation.png",  &death);
-	loadTextureAsync("berserker_idle.png",	 &berserkerIdle);
-	loadTextureAsync("berserker_run.png",	 &berserkerRun);
-	loadTextureAsync("wizard_idle.png",		 &wizardIdle);
-	loadTextureAsync("wizard_run.png",		 &wizardRun);
-	loadTextureAsync("hunter_idle.png",		 &hunterIdle);
-	loadTextureAsync("hunter_run.png",		 &hunterRun);
-	loadTextureAsync("Waraxe.png",			 &axe);
-	loadTextureAsync("Staff.png",			 &staff);
-	loadTextureAsync("Bow.png",				 &bow);
-	loadTextureAsync("Waraxe_p.png",		 &axeProjectile);
-	loadTextureAsync("Staff_p.png",			 &staffProjectile);
-	loadTextureAsync("Bow_p.png",			 &bowProjectile);
-	loadTextureAsync("chargeEffect.png",	 &chargeEffect);
-	loadTextureAsync("iceSpike.png",		 &iceSpike);
-#endif
+	loadAtlasCacheTask.resources = this;
+	for (uint32 i = 0; i < textureResourceCount; ++i)
+	{
+		hashTasks[i].resource = &textureResources[i];
+		loadAtlasCacheTask.addDependency(&hashTasks[i]);
+	}
 
-	audioClipDeath = App->modSound->loadAudioClip("death.wav");
+	App->modTaskManager->scheduleTask(&loadAtlasCacheTask, this);
+	for (uint32 i = 0; i < textureResourceCount; ++i)
+	{
+		App->modTaskManager->scheduleTask(&hashTasks[i], this);
+	}
+#endif
 
 	return true;
 }
 
-#if defined(USE_TASK_MANAGER)
+void ModuleResources::addTextureResource(const char *filename, Texture **texture)
+{
+	ASSERT(textureResourceCount < MAX_RESOURCES);
+
+	TextureResource &resource = textureResources[textureResourceCount++];
+	resource.filename = filename;
+	resource.texture = texture;
+}
 
-void ModuleResources::loadTextureAsync(const char * filename, Texture **texturePtrAddress)
+void ModuleResources::hashSource(TextureResource &resource)
 {
-	ASSERT(taskCount < MAX_RESOURCES);
-	
-	TaskLoadTexture *task = &tasks[taskCount++];
-	task->owner = this;
-	task->filename = filename;
-	task->texture = texturePtrAddress;
+	resource.sourceHash = hashFileContents(resource.filename);
+}
 
-	App->modTaskManager->scheduleTask(task, this);
+void ModuleResources::decodeImage(TextureResource &resource)
+{
+	int channels;
+	resource.pixels = stbi_load(resource.filename, &resource.width, &resource.height, &channels, 4);
 }
 
-void ModuleResources::onTaskFinished(Task * task)
+bool ModuleResources::validateAtlasCache()
 {
-	ASSERT(task != nullptr);
+	if (!atlas.load(ATLAS_CACHE_FILENAME))
+	{
+		return false;
+	}
+
+	// Valid only if it contains exactly the current sources
+	bool valid = atlas.regionCount == textureResourceCount;
+	for (uint32 i = 0; valid && i < textureResourceCount; ++i)
+	{
+		const TextureAtlas::Region *region = atlas.findRegion(textureResources[i].filename);
+		valid = region != nullptr && region->sourceHash == textureResources[i].sourceHash;
+	}
+
+	if (!valid)
+	{
+		atlas.clear();
+	}
 
-	TaskLoadTexture *taskLoadTexture = dynamic_cast<TaskLoadTexture*>(task);
+	return valid;
+}
 
-	for (uint32 i = 0; i < taskCount; ++i)
+bool ModuleResources::buildAtlas()
+{
+	AtlasImage images[MAX_RESOURCES];
+	for (uint32 i = 0; i < textureResourceCount; ++i)
 	{
-		if (task == &tasks[i])
+		const TextureResource &resource = textureResources[i];
+		if (resource.pixels == nullptr)
 		{
-			finishedTaskCount++;
-			task = nullptr;
-			break;
+			return false;
 		}
-	}
 
-	ASSERT(task == nullptr);
+		images[i].name = resource.filename;
+		images[i].pixels = resource.pixels;
+		images[i].width = resource.width;
+		images[i].height = resource.height;
+		images[i].sourceHash = resource.sourceHash;
+	}
 
-	if (finishedTaskCount == taskCount)
+	if (!atlas.build(images, textureResourceCount))
 	{
-		finishedLoading = true;
+		return false;
+	}
 
-		// Create the explosion animation clip
-		deathClip = App->modRender->addAnimationClip();
-		deathClip->frameTime = 0.1f;
-		deathClip->loop = true;
-		for (int i = 0; i < 3; ++i)
+	atlas.save(ATLAS_CACHE_FILENAME);
+	return true;
+}
+
+void ModuleResources::finishLoading(bool atlasReady)
+{
+	if (atlasReady)
+	{
+		createTexturesFromAtlas();
+	}
+	else
+	{
+		// Fall back to one texture per file
+		ELOG("ModuleResources: could not build the texture atlas");
+		for (uint32 i = 0; i < textureResourceCount; ++i)
 		{
-			float x = (i % 3) / 3.0f;
-			float y = 0.f;
-			float w = 1.0f / 3.0f;
-			float h = 1.0f;
-			deathClip->addFrameRect(vec4{ x, y, w, h });
+			*textureResources[i].texture = App->modTextures->loadTexture(textureResources[i].filename);
 		}
+	}
 
-		//Create player idle animation clip
-		playerIdleClip = App->modRender->addAnimationClip();
-		playerIdleClip->frameTime = 0.2f;
-		playerIdleClip->loop = true;
-		for (int i = 0; i < 4; ++i)
+	for (uint32 i = 0; i < textureResourceCount; ++i)
+	{
+		stbi_image_free(textureResources[i].pixels);
+		textureResources[i].pixels = nullptr;
+	}
+
+	finishedLoadingStepCount++;
+	finishedLoading = true;
+
+	const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - loadingStartTime;
+	LOG("ModuleResources: %u textures loaded in %.1f ms (%s)", textureResourceCount, elapsed.count(),
+		loadedFromCache ? "atlas cache" : "decoded");
+}
+
+void ModuleResources::createTexturesFromAtlas()
+{
+	// NOTE: All the pages are uploaded in a row, then the regions only
+	// reference them
+	Texture *pages[TextureAtlas::MAX_PAGES] = {};
+	for (uint32 i = 0; i < atlas.pageCount; ++i)
+	{
+		const TextureAtlas::Page &page = atlas.pages[i];
+		pages[i] = App->modTextures->loadTexture((void*)page.pixels, page.width, page.height);
+	}
+
+	for (uint32 i = 0; i < textureResourceCount; ++i)
+	{
+		const TextureResource &resource = textureResources[i];
+		const TextureAtlas::Region *region = atlas.findRegion(resource.filename);
+		if (region != nullptr && pages[region->page] != nullptr)
 		{
-			float x = (i % 4) / 4.0f;
-			float y = 0;
-			float w = 1.0f / 4.0f;
-			float h = 1.0f;
-			playerIdleClip->addFrameRect(vec4{ x, y, w, h });
+			vec2 size = vec2{ (float)region->width, (float)region->height };
+			*resource.texture = App->modTextures->loadAtlasRegion(resource.filename, pages[region->page], atlas.regionUVRect(*region), size);
 		}
+	}
+
+	// The pixels are in video memory now
+	atlas.clear();
+}
+
+#if defined(USE_TASK_MANAGER)
+
+void ModuleResources::scheduleAtlasBuild()
+{
+	LOG("ModuleResources: %s is missing or out of date, rebuilding it", ATLAS_CACHE_FILENAME);
+
+	buildAtlasTask.resources = this;
+	for (uint32 i = 0; i < textureResourceCount; ++i)
+	{
+		decodeTasks[i].resource = &textureResources[i];
+		buildAtlasTask.addDependency(&decodeTasks[i]);
+	}
 
-		//Create player run animation clip
-		playerRunClip = App->modRender->addAnimationClip();
-		playerRunClip->frameTime = 0.1f;
-		playerRunClip->loop = true;
-		for (int i = 0; i < 7; ++i)
+	App->modTaskManager->scheduleTask(&buildAtlasTask, this);
+	for (uint32 i = 0; i < textureResourceCount; ++i)
+	{
+		App->modTaskManager->scheduleTask(&decodeTasks[i], this);
+	}
+}
+
+void ModuleResources::onTaskFinished(Task * task)
+{
+	ASSERT(task != nullptr);
+
+	if (task == &loadAtlasCacheTask)
+	{
+		if (loadAtlasCacheTask.valid)
 		{
-			float x = (i % 7) / 7.0f;
-			float y = 0;
-			float w = 1.0f / 7.0f;
-			float h = 1.0f;
-			playerRunClip->addFrameRect(vec4{ x, y, w, h });
+			// Nothing to decode, the pages are uploaded from the mapped file
+			loadedFromCache = true;
+			finishedLoadingStepCount += textureResourceCount + 1;
+			finishLoading(true);
 		}
-
-		//Create charge effect animation clip
-		chargeEffectClip = App->modRender->addAnimationClip();
-		chargeEffectClip->frameTime = 0.075f;
-		chargeEffectClip->loop = true;
-		for (int i = 0; i < 4; ++i)
+		else
 		{
-			float x = (i % 4) / 4.0f;
-			float y = 0;
-			float w = 1.0f / 4.0f;
-			float h = 1.0f;
-			chargeEffectClip->addFrameRect(vec4{ x, y, w, h });
+			scheduleAtlasBuild();
 		}
 	}
+	else if (task == &buildAtlasTask)
+	{
+		finishedLoadingStepCount++;
+		finishLoading(buildAtlasTask.built);
+	}
+	else
+	{
+		// One of the hashes or decodes
+		finishedLoadingStepCount++;
+	}
 }
 
 #endif
+
+void ModuleResources::createAnimationClips()
+{
+	// Create the explosion animation clip
+	deathClip = App->modRender->addAnimationClip();
+	deathClip->frameTime = 0.1f;
+	deathClip->loop = true;
+	for (int i = 0; i < 3; ++i)
+	{
+		float x = (i % 3) / 3.0f;
+		float y = 0.f;
+		float w = 1.0f / 3.0f;
+		float h = 1.0f;
+		deathClip->addFrameRect(vec4{ x, y, w, h });
+	}
+
+	//Create player idle animation clip
+	playerIdleClip = App->modRender->addAnimationClip();
+	playerIdleClip->frameTime = 0.2f;
+	playerIdleClip->loop = true;
+	for (int i = 0; i < 4; ++i)
+	{
+		float x = (i % 4) / 4.0f;
+		float y = 0;
+		float w = 1.0f / 4.0f;
+		float h = 1.0f;
+		playerIdleClip->addFrameRect(vec4{ x, y, w, h });
+	}
+
+	//Create player run animation clip
+	playerRunClip = App->modRender->addAnimationClip();
+	playerRunClip->frameTime = 0.1f;
+	playerRunClip->loop = true;
+	for (int i = 0; i < 7; ++i)
+	{
+		float x = (i % 7) / 7.0f;
+		float y = 0;
+		float w = 1.0f / 7.0f;
+		float h = 1.0f;
+		playerRunClip->addFrameRect(vec4{ x, y, w, h });
+	}
+
+	//Create charge effect animation clip
+	chargeEffectClip = App->modRender->addAnimationClip();
+	chargeEffectClip->frameTime = 0.075f;
+	chargeEffectClip->loop = true;
+	for (int i = 0; i < 4; ++i)
+	{
+		float x = (i % 4) / 4.0f;
+		float y = 0;
+		float w = 1.0f / 4.0f;
+		float h = 1.0f;
+		chargeEffectClip->addFrameRect(vec4{ x, y, w, h });
+	}
+}
@@ -42,36 +42,114 @@ public:
 
 	AudioClip *audioClipDeath = nullptr;
 
+	// NOTE: The main menu only needs the background, the sprites keep
+	// loading in the background after it appears
+	bool menuResourcesLoaded = false;
 	bool finishedLoading = false;
 
+	// Ratio of loading steps completed, in [0, 1]
+	float loadingProgress() const;
+
 	Texture* GetTextureByFile(std::string fileName);
 
 private:
 
 	bool init() override;
 
+	// Sprite textures, packed into an atlas that is cached pre-decoded
+	struct TextureResource
+	{
+		const char *filename = nullptr;
+		Texture **texture = nullptr;
+		uint64 sourceHash = 0;
+
+		// Decoded pixels (RGBA8), only while building the atlas
+		uint8 *pixels = nullptr;
+		int width = 0;
+		int height = 0;
+	};
+
+	static const int MAX_RESOURCES = 32;
+	TextureResource textureResources[MAX_RESOURCES];
+	uint32 textureResourceCount = 0;
+
+	void addTextureResource(const char *filename, Texture **texture);
+
+	static void hashSource(TextureResource &resource);
+	static void decodeImage(TextureResource &resource);
+
+	// These are safe to call from the workers
+	bool validateAtlasCache();
+	bool buildAtlas();
+
+	void finishLoading(bool atlasReady);
+	void createTexturesFromAtlas();
+	void createAnimationClips();
+
+	TextureAtlas atlas;
+
+	// Progress and timing
+	uint32 loadingStepCount = 0;
+	std::atomic<uint32> finishedLoadingStepCount{ 0 };
+	std::chrono::steady_clock::time_point loadingStartTime;
+	bool loadedFromCache = false;
+
 #if defined(USE_TASK_MANAGER)
-	
-	class TaskLoadTexture : public Task
+
+	// NOTE: Loading pipeline, each arrow is a task dependency:
+	//   TaskHashSource (one per texture) -> TaskLoadAtlasCache
+	// and only when the cache is missing or stale:
+	//   TaskDecodeImage (one per texture) -> TaskBuildAtlas
+	// When the last one finishes, the main thread uploads all the atlas
+	// pages at once and creates the textures.
+
+	class TaskHashSource : public Task
 	{
 	public:
 
-		const char *filename = nullptr;
-		Texture **texture = nullptr;
+		TextureResource *resource = nullptr;
 
 		void execute() override;
 	};
 
-	static const int MAX_RESOURCES = 32;
-	TaskLoadTexture tasks[MAX_RESOURCES] = {};
-	uint32 taskCount = 0;
-	uint32 finishedTaskCount = 0;
+	class TaskDecodeImage : public Task
+	{
+	public:
 
-	void onTaskFinished(Task *task) override;
+		TextureResource *resource = nullptr;
+
+		void execute() override;
+	};
+
+	class TaskLoadAtlasCache : public Task
+	{
+	public:
+
+		ModuleResources *resources = nullptr;
+		bool valid = false;
+
+		void execute() override;
+	};
 
-	void loadTextureAsync(const char *filename, Texture **texturePtrAddress);
+	class TaskBuildAtlas : public Task
+	{
+	public:
+
+		ModuleResources *resources = nullptr;
+		bool built = false;
+
+		void execute() override;
+	};
+
+	TaskHashSource hashTasks[MAX_RESOURCES];
+	TaskDecodeImage decodeTasks[MAX_RESOURCES];
+	TaskLoadAtlasCache loadAtlasCacheTask;
+	TaskBuildAtlas buildAtlasTask;
+
+	void scheduleAtlasBuild();
+
+	void onTaskFinished(Task *task) override;
 
 #endif
 
 };
-
@@ -293,8 +293,7 @@ bool ModuleSound::cleanUp()
 {
 	for (uint32 i = 0; i < ArrayCount(audioClips); ++i)
 	{
-		free(audioClips[i].samples);
-		audioClips[i] = {};
+		releaseAudioClipSamples(i);
 	}
 
 	return true;
@@ -303,17 +302,32 @@ bool ModuleSound::cleanUp()
 AudioClip * ModuleSound::loadAudioClip(const char * filename)
 {
 	AudioClip *audioClip = nullptr;
+	uint32 audioClipIndex = 0;
 
 	for (uint32 i = 0; i < ArrayCount(audioClips); ++i)
 	{
 		if (audioClips[i].samples == nullptr) {
 			audioClip = &audioClips[i];
+			audioClipIndex = i;
 			break;
 		}
 	}
 
 	if (audioClip != nullptr)
 	{
+		// Use the PCM samples in place from the cache if they are up to date
+		const uint64 sourceHash = hashFileContents(filename);
+		CachedAsset &cachedSound = audioClipCaches[audioClipIndex];
+		if (cachedSound.open(filename, CachedAssetType::Sound, sourceHash))
+		{
+			audioClip->samplingRate = cachedSound.params[0];
+			audioClip->bitsPerSample = (uint16)cachedSound.params[1];
+			audioClip->channelCount = (uint16)cachedSound.params[2];
+			audioClip->sampleCount = cachedSound.params[3];
+			audioClip->samples = (void*)cachedSound.data;
+			return audioClip;
+		}
+
 		FILE *file = fopen(filename, "rb");
 		if (file != nullptr)
 		{
@@ -365,6 +379,11 @@ AudioClip * ModuleSound::loadAudioClip(const char * filename)
 			audioClip->samples = data;
 
 			fclose(file);
+
+			// Save the PCM samples for the next launch
+			const uint32 params[CachedAsset::MAX_PARAMS] = {
+				audioClip->samplingRate, audioClip->bitsPerSample, audioClip->channelCount, audioClip->sampleCount };
+			CachedAsset::save(filename, CachedAssetType::Sound, sourceHash, params, data, dataSize);
 		}
 		else
 		{
@@ -379,8 +398,22 @@ AudioClip * ModuleSound::loadAudioClip(const char * filename)
 
 void ModuleSound::freeAudioClip(AudioClip * audioClip)
 {
-	free(audioClip->samples);
-	*audioClip = {};
+	releaseAudioClipSamples((uint32)(audioClip - audioClips));
+}
+
+void ModuleSound::releaseAudioClipSamples(uint32 index)
+{
+	ASSERT(index < ArrayCount(audioClips));
+
+	if (audioClipCaches[index].isOpen())
+	{
+		audioClipCaches[index].close();
+	}
+	else
+	{
+		free(audioClips[index].samples);
+	}
+	audioClips[index] = {};
 }
 
 void ModuleSound::playAudioClip(AudioClip * audioClip)
@@ -45,6 +45,11 @@ private:
 
 	AudioClip audioClips[2] = {};
 
+	// Mapped cache entry of each clip, whose samples point into it
+	CachedAsset audioClipCaches[2];
+
+	void releaseAudioClipSamples(uint32 index);
+
 	enum audio_source_flags {
 		AUDIO_SOURCE_START_BIT = 1<<0,
 		AUDIO_SOURCE_LOOPS_BIT = 1<<1
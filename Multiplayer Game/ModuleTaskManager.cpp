@@ -1,82 +1,140 @@
 #include "Networks.h"
 
 
-inline void enqueue(Task **queue, int *front, int *back, int max_elems, Task * task)
+static std::thread threads[MAX_TASK_THREADS];
+
+// NOTE: Workers only sleep on these after finding all queues empty,
+// pushing and popping tasks is lock-free
+static std::mutex sleepMutex;
+static std::condition_variable wakeEvent;
+
+// Index of the deque owned by the current thread (0 for the main thread)
+static thread_local int currentThreadIndex = 0;
+
+
+//////////////////////////////////////////////////////////////////////
+// Task
+//////////////////////////////////////////////////////////////////////
+
+void Task::addDependency(Task *task)
+{
+	ASSERT(task->dependentCount < MAX_TASK_DEPENDENTS);
+	task->dependents[task->dependentCount++] = this;
+	unfinishedDependencies++;
+}
+
+
+//////////////////////////////////////////////////////////////////////
+// TaskDeque
+//////////////////////////////////////////////////////////////////////
+
+bool ModuleTaskManager::TaskDeque::push(Task *task)
 {
-	ASSERT(*back != *front);
-	queue[*back] = task;
-	if (*front == -1) {
-		*front = *back;
+	int64 b = bottom.load(std::memory_order_relaxed);
+	int64 t = top.load(std::memory_order_acquire);
+	if (b - t >= MAX_TASKS)
+	{
+		return false;
 	}
-	*back = (*back + 1) % max_elems;
+
+	tasks[b & (MAX_TASKS - 1)].store(task, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	bottom.store(b + 1, std::memory_order_relaxed);
+	return true;
 }
 
-inline Task *dequeue(Task **queue, int *front, int *back, int max_elems)
+Task * ModuleTaskManager::TaskDeque::pop()
 {
-	ASSERT(*front != -1);
-	Task *task = queue[*front];
-	queue[*front] = nullptr;
-	*front = (*front + 1) % max_elems;
-	if (*front == *back) {
-		*front = -1;
-		*back = 0;
+	int64 b = bottom.load(std::memory_order_relaxed) - 1;
+	bottom.store(b, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64 t = top.load(std::memory_order_relaxed);
+
+	if (t > b)
+	{
+		// Empty
+		bottom.store(b + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	Task *task = tasks[b & (MAX_TASKS - 1)].load(std::memory_order_relaxed);
+
+	if (t == b)
+	{
+		// Last task, race against the thieves
+		if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		{
+			task = nullptr;
+		}
+		bottom.store(b + 1, std::memory_order_relaxed);
 	}
+
 	return task;
 }
 
+Task * ModuleTaskManager::TaskDeque::steal()
+{
+	int64 t = top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64 b = bottom.load(std::memory_order_acquire);
+
+	if (t >= b)
+	{
+		return nullptr;
+	}
+
+	Task *task = tasks[t & (MAX_TASKS - 1)].load(std::memory_order_relaxed);
+	if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+	{
+		return nullptr; // Lost the race
+	}
+
+	return task;
+}
 
-static const int MAX_THREADS = 4;
-static std::thread threads[MAX_THREADS];
 
-static std::mutex scheduledMutex;
-static std::mutex finishedMutex;
-static std::condition_variable event;
+//////////////////////////////////////////////////////////////////////
+// ModuleTaskManager
+//////////////////////////////////////////////////////////////////////
 
-void ModuleTaskManager::threadMain()
+void ModuleTaskManager::threadMain(int threadIndex)
 {
-	Task *task = nullptr;
-	
-	while (true)
-	{
-		{
-			std::unique_lock<std::mutex> lock(scheduledMutex);
-			while (scheduledTasksFront == -1 && exitFlag == false)
-			{
-				event.wait(lock);
-			}
+	currentThreadIndex = threadIndex;
 
-			if (exitFlag)
-			{
-				break;
-			}
-			else
-			{
-				task = dequeue(scheduledTasks,
-							   &scheduledTasksFront,
-							   &scheduledTasksBack,
-							   MAX_TASKS);
-			}
-		}
+	char threadName[32];
+	sprintf_s(threadName, sizeof(threadName), "Worker %d", threadIndex);
+	PROFILE_THREAD_NAME(threadName);
 
-		task->execute();
+	while (!exitFlag)
+	{
+		Task *task = findTask(threadIndex);
 
+		if (task != nullptr)
 		{
-			std::unique_lock<std::mutex> lock(finishedMutex);
-
-			enqueue(finishedTasks,
-					&finishedTasksFront,
-					&finishedTasksBack,
-					MAX_TASKS,
-					task);
+			runTask(task);
+		}
+		else
+		{
+			std::unique_lock<std::mutex> lock(sleepMutex);
+			sleepingThreadCount++;
+			while (queuedTaskCount == 0 && !exitFlag)
+			{
+				wakeEvent.wait(lock);
+			}
+			sleepingThreadCount--;
 		}
 	}
 }
 
 bool ModuleTaskManager::init()
 {
-	for (auto &thread : threads)
+	// NOTE: One worker per hardware thread, leaving one for the main thread
+	int hardwareThreadCount = (int)std::thread::hardware_concurrency();
+	threadCount = max(1, min(hardwareThreadCount - 1, MAX_TASK_THREADS));
+
+	for (int i = 0; i < threadCount; ++i)
 	{
-		thread = std::thread(&ModuleTaskManager::threadMain, this);
+		threads[i] = std::thread(&ModuleTaskManager::threadMain, this, i + 1);
 	}
 
 	return true;
@@ -84,19 +142,24 @@ bool ModuleTaskManager::init()
 
 bool ModuleTaskManager::update()
 {
-	if (finishedTasksFront != -1)
-	{
-		std::unique_lock<std::mutex> lock(finishedMutex);
+	Task *task = finishedTasks.exchange(nullptr);
 
-		while (finishedTasksFront != -1)
-		{
-			Task *task = dequeue(finishedTasks,
-								 &finishedTasksFront,
-								 &finishedTasksBack,
-								 MAX_TASKS);
+	// The stack is LIFO, reverse it to notify in completion order
+	Task *reversed = nullptr;
+	while (task != nullptr)
+	{
+		Task *next = task->nextFinished;
+		task->nextFinished = reversed;
+		reversed = task;
+		task = next;
+	}
 
-			task->owner->onTaskFinished(task);
-		}
+	while (reversed != nullptr)
+	{
+		Task *next = reversed->nextFinished;
+		reversed->nextFinished = nullptr;
+		reversed->owner->onTaskFinished(reversed);
+		reversed = next;
 	}
 
 	return true;
@@ -105,14 +168,14 @@ bool ModuleTaskManager::update()
 bool ModuleTaskManager::cleanUp()
 {
 	{
-		std::unique_lock<std::mutex> lock(scheduledMutex);
+		std::unique_lock<std::mutex> lock(sleepMutex);
 		exitFlag = true;
-		event.notify_all();
+		wakeEvent.notify_all();
 	}
 
-	for (auto &thread : threads)
+	for (int i = 0; i < threadCount; ++i)
 	{
-		thread.join();
+		threads[i].join();
 	}
 
 	return true;
@@ -122,13 +185,161 @@ void ModuleTaskManager::scheduleTask(Task *task, Module *owner)
 {
 	task->owner = owner;
 
-	std::unique_lock<std::mutex> lock(scheduledMutex);
+	if (--task->unfinishedDependencies == 0)
+	{
+		pushTask(task);
+	}
+}
+
+void ModuleTaskManager::executeTasksAndWait(Task **tasks, int taskCount)
+{
+	std::atomic<int> pendingTasks{ taskCount };
+
+	for (int i = 0; i < taskCount; ++i)
+	{
+		tasks[i]->pendingTasksInBatch = &pendingTasks;
+		scheduleTask(tasks[i], nullptr);
+	}
+
+	// Help the workers instead of just blocking
+	while (pendingTasks > 0)
+	{
+		Task *task = findTask(currentThreadIndex);
+		if (task != nullptr)
+		{
+			runTask(task);
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+void ModuleTaskManager::parallelFor(int count, int minBatchSize, ParallelForBody *body)
+{
+	class ParallelForTask : public Task
+	{
+	public:
+
+		void execute() override { body->execute(begin, end); }
+
+		ParallelForBody *body = nullptr;
+		int begin = 0;
+		int end = 0;
+	};
+
+	static const int MAX_BATCHES = 64;
+
+	if (count <= 0) return;
+
+	// NOTE: A few batches per thread so that stealing can balance them
+	int batchCount = (count + minBatchSize - 1) / max(minBatchSize, 1);
+	batchCount = max(1, min(batchCount, min((threadCount + 1) * 4, MAX_BATCHES)));
+
+	if (batchCount == 1)
+	{
+		body->execute(0, count);
+		return;
+	}
+
+	ParallelForTask batches[MAX_BATCHES];
+	Task *tasks[MAX_BATCHES];
+
+	for (int i = 0; i < batchCount; ++i)
+	{
+		batches[i].body = body;
+		batches[i].begin = (int)((int64)count * i / batchCount);
+		batches[i].end = (int)((int64)count * (i + 1) / batchCount);
+		tasks[i] = &batches[i];
+	}
+
+	executeTasksAndWait(tasks, batchCount);
+}
+
+void ModuleTaskManager::pushTask(Task *task)
+{
+	// NOTE: Counted before pushing so that it never goes below the
+	// actual number of queued tasks
+	queuedTaskCount++;
+
+	if (!deques[currentThreadIndex].push(task))
+	{
+		// Queue full, run it right away instead of losing it
+		queuedTaskCount--;
+		runTask(task);
+		return;
+	}
+
+	if (sleepingThreadCount > 0)
+	{
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		wakeEvent.notify_one();
+	}
+}
+
+Task * ModuleTaskManager::findTask(int threadIndex)
+{
+	Task *task = deques[threadIndex].pop();
+
+	if (task == nullptr)
+	{
+		// Steal from the rest of threads, starting from the next one
+		for (int i = 1; i <= threadCount && task == nullptr; ++i)
+		{
+			task = deques[(threadIndex + i) % (threadCount + 1)].steal();
+		}
+	}
+
+	if (task != nullptr)
+	{
+		queuedTaskCount--;
+	}
+
+	return task;
+}
+
+void ModuleTaskManager::runTask(Task *task)
+{
+	{
+		PROFILE_SCOPE("Task");
+		task->execute();
+	}
+
+	// Reset the task so that it can be scheduled again, then release the
+	// tasks waiting for it
+	Task *dependents[MAX_TASK_DEPENDENTS];
+	int dependentCount = task->dependentCount;
+	for (int i = 0; i < dependentCount; ++i)
+	{
+		dependents[i] = task->dependents[i];
+		task->dependents[i] = nullptr;
+	}
+	task->dependentCount = 0;
+	task->unfinishedDependencies = 1;
 
-	enqueue(scheduledTasks,
-			&scheduledTasksFront,
-			&scheduledTasksBack,
-			MAX_TASKS,
-			task);
+	std::atomic<int> *pendingTasksInBatch = task->pendingTasksInBatch;
+	task->pendingTasksInBatch = nullptr;
+
+	if (pendingTasksInBatch != nullptr)
+	{
+		// Task from executeTasksAndWait(), the caller may return right after
+		(*pendingTasksInBatch)--;
+	}
+	else
+	{
+		Task *head = finishedTasks.load();
+		do
+		{
+			task->nextFinished = head;
+		} while (!finishedTasks.compare_exchange_weak(head, task));
+	}
 
-	event.notify_one();
+	for (int i = 0; i < dependentCount; ++i)
+	{
+		if (--dependents[i]->unfinishedDependencies == 0)
+		{
+			pushTask(dependents[i]);
+		}
+	}
 }
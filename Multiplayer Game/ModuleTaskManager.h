@@ -6,7 +6,38 @@ public:
 
 	virtual void execute() = 0;
 
+	// This task won't start until the given one has finished. Dependencies
+	// have to be declared before scheduling any of the two tasks.
+	void addDependency(Task *task);
+
 	Module *owner = nullptr;
+
+private:
+
+	friend class ModuleTaskManager;
+
+	// NOTE: Starts at 1 for the task itself not being scheduled yet, so
+	// whoever brings it down to 0 (scheduleTask or the last dependency to
+	// finish) is the one that pushes it to a queue
+	std::atomic<int> unfinishedDependencies{ 1 };
+
+	Task *dependents[MAX_TASK_DEPENDENTS] = {};
+	int dependentCount = 0;
+
+	// For tasks run with executeTasksAndWait() / parallelFor()
+	std::atomic<int> *pendingTasksInBatch = nullptr;
+
+	// Link in the list of finished tasks
+	Task *nextFinished = nullptr;
+};
+
+// NOTE: Body of a parallelFor() call, executed for consecutive ranges
+// [begin, end) of the iteration space from several threads at once
+class ParallelForBody
+{
+public:
+
+	virtual void execute(int begin, int end) = 0;
 };
 
 class ModuleTaskManager : public Module
@@ -22,21 +53,61 @@ public:
 	bool cleanUp() override;
 
 
-	// To schedule new tasks
+	// To schedule new tasks (onTaskFinished() is called on the owner from
+	// the main thread once the task is finished)
 
 	void scheduleTask(Task *task, Module *owner);
 
-	void threadMain();
+	// To run a batch of tasks in the workers and wait until all of them
+	// are finished. The calling thread also executes tasks meanwhile.
+	// onTaskFinished() is not called for these tasks.
+
+	void executeTasksAndWait(Task **tasks, int taskCount);
+
+	// To split [0, count) in ranges of at least minBatchSize iterations
+	// and run them in parallel, returns when all of them are finished
+
+	void parallelFor(int count, int minBatchSize, ParallelForBody *body);
+
+	int getThreadCount() const { return threadCount; }
+
+	void threadMain(int threadIndex);
 
 private:
 
-	Task* scheduledTasks[MAX_TASKS];
-	int scheduledTasksFront = -1;
-	int scheduledTasksBack = 0;
+	// NOTE: Chase-Lev work-stealing deque. The owner thread pushes and pops
+	// at the bottom, the rest of threads steal from the top.
+	class TaskDeque
+	{
+	public:
+
+		bool push(Task *task);
+		Task *pop();
+		Task *steal();
+
+	private:
+
+		static_assert((MAX_TASKS & (MAX_TASKS - 1)) == 0, "MAX_TASKS must be a power of two");
+
+		std::atomic<int64> top{ 0 };
+		std::atomic<int64> bottom{ 0 };
+		std::atomic<Task*> tasks[MAX_TASKS] = {};
+	};
+
+	void pushTask(Task *task);
+	Task *findTask(int threadIndex);
+	void runTask(Task *task);
+
+	// One deque per worker, plus one for the main thread (index 0)
+	TaskDeque deques[MAX_TASK_THREADS + 1];
+	int threadCount = 0;
+
+	// Hint for the workers to decide whether to go to sleep
+	std::atomic<int> queuedTaskCount{ 0 };
+	std::atomic<int> sleepingThreadCount{ 0 };
 
-	Task* finishedTasks[MAX_TASKS];
-	int finishedTasksFront = -1;
-	int finishedTasksBack = 0;
+	// Lock-free stack of tasks pending onTaskFinished()
+	std::atomic<Task*> finishedTasks{ nullptr };
 
-	bool exitFlag = false;
+	std::atomic<bool> exitFlag{ false };
 };
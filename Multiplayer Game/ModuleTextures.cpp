@@ -19,6 +19,8 @@ bool ModuleTextures::cleanUp()
 			texture.filename = "";
 			texture.size = vec2{ -1.0f , -1.0f };
 			texture.used = false;
+			texture.atlasPage = nullptr;
+			texture.uvRect = vec4{ 0.0f, 0.0f, 1.0f, 1.0f };
 		}
 	}
 
@@ -61,19 +63,44 @@ Texture * ModuleTextures::loadTexture(void * pixels, int width, int height)
 	return &texture;
 }
 
+Texture * ModuleTextures::loadAtlasRegion(const char *filename, Texture *atlasPage, vec4 uvRect, vec2 size)
+{
+	ASSERT(atlasPage != nullptr && atlasPage->shaderResource != nullptr);
+
+	Texture & texture = getTextureSlotForFilename(filename);
+
+	if (texture.shaderResource == nullptr)
+	{
+		// NOTE: Every region holds a reference to the page resource, so
+		// that they can be released independently
+		atlasPage->shaderResource->AddRef();
+		texture.shaderResource = atlasPage->shaderResource;
+		texture.filename = filename;
+		texture.size = size;
+		texture.used = true;
+		texture.atlasPage = atlasPage;
+		texture.uvRect = uvRect;
+	}
+
+	return &texture;
+}
+
 void ModuleTextures::freeTexture(Texture* tex)
 {
 	if (tex != nullptr)
 	{
+		// NOTE: Compared by slot, atlas regions share the shaderResource
 		for (auto &texture : _textures)
 		{
-			if (texture.shaderResource == tex->shaderResource)
+			if (&texture == tex && texture.shaderResource != nullptr)
 			{
 				texture.shaderResource->Release();
 				texture.shaderResource = nullptr;
 				texture.filename = "";
 				texture.size = vec2{ -1.0f, -1.0f };
 				texture.used = false;
+				texture.atlasPage = nullptr;
+				texture.uvRect = vec4{ 0.0f, 0.0f, 1.0f, 1.0f };
 				break;
 			}
 		}
@@ -84,6 +111,20 @@ ID3D11ShaderResourceView* ModuleTextures::loadD3DTextureFromFile(const char * fi
 {
 	ID3D11ShaderResourceView *shaderResourceView = nullptr;
 
+	// Upload the decoded pixels straight from the cache if they are up to date
+	const uint64 sourceHash = hashFileContents(filename);
+	CachedAsset cachedImage;
+	if (cachedImage.open(filename, CachedAssetType::Image, sourceHash))
+	{
+		*width = (int)cachedImage.params[0];
+		*height = (int)cachedImage.params[1];
+		if (cachedImage.dataSize == (uint64)(*width) * (*height) * 4)
+		{
+			return loadD3DTextureFromPixels((void*)cachedImage.data, *width, *height);
+		}
+		cachedImage.close(); // Unmapped so it can be overwritten below
+	}
+
 	// Read image pixels
 	int nchannels;           // NOTE(jesus): nchanels would be the number of channels without forcing bytes_per_pixel
 	int bytes_per_pixel = 4; // NOTE(jesus): 4 is the desired (and final) number of channels
@@ -105,6 +146,10 @@ ID3D11ShaderResourceView* ModuleTextures::loadD3DTextureFromFile(const char * fi
 
 	shaderResourceView = loadD3DTextureFromPixels(pixels, *width, *height);
 
+	// Save the decoded pixels for the next launch
+	const uint32 params[CachedAsset::MAX_PARAMS] = { (uint32)*width, (uint32)*height };
+	CachedAsset::save(filename, CachedAssetType::Image, sourceHash, params, pixels, (uint64)(*width) * (*height) * 4);
+
 	// Free image pixels
 	stbi_image_free(pixels);
 
@@ -8,6 +8,11 @@ struct Texture
 	const char *filename = "";
 	vec2 size = vec2{ -1.0f };
 	bool used = false;
+
+	// Region of an atlas page: the page texture, whose shaderResource is
+	// shared, and the normalized {u, v, width, height} within it
+	Texture *atlasPage = nullptr;
+	vec4 uvRect = vec4{ 0.0f, 0.0f, 1.0f, 1.0f };
 };
 
 class ModuleTextures : public Module
@@ -27,8 +32,13 @@ public:
 
 	Texture *loadTexture(void *pixels, int width, int height);
 
+	Texture *loadAtlasRegion(const char *filename, Texture *atlasPage, vec4 uvRect, vec2 size);
+
 	void freeTexture(Texture *texture);
 
+	// Position of the texture in the pool, to use as a compact key
+	uint16 getTextureIndex(const Texture *texture) const { return (uint16)(texture - _textures); }
+
 
 private:
 
@@ -72,18 +72,32 @@ bool ModuleUI::gui()
 
 		if (ImGui::BeginTabItem("Profiling"))
 		{
+			if (profileIsCapturing())
+			{
+				ImGui::Text("Capturing...");
+			}
+			else
+			{
+				if (ImGui::Button("Capture 1 frame")) profileRequestCapture(1);
+				ImGui::SameLine();
+				if (ImGui::Button("Capture 60 frames")) profileRequestCapture(60);
+			}
+
 			ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.8f, 0.8f, 0.8f, 1.0f));
-			ImGui::Text("DEBUG CYCLE COUNTS");
+			ImGui::Text("PROFILE BLOCKS (LAST FRAME)");
 			ImGui::Separator();
-			for (int i = 0; i < DebugCycleCounter_Count; ++i)
+			const uint32 blockCount = getProfileBlockCount();
+			for (uint32 i = 0; i < blockCount; ++i)
 			{
-				if (DebugCycleCountersFront[i].hitCount > 0)
+				ProfileBlockStats stats = getProfileBlockStats(i);
+				if (stats.hitCount > 0)
 				{
-					ImGui::Text(" - %16s: %9I64u cy | %4d hits | %9I64u cy/hit",
-						DebugCycleCountersFront[i].label,
-						DebugCycleCountersFront[i].cycleCount,
-						DebugCycleCountersFront[i].hitCount,
-						DebugCycleCountersFront[i].cycleCount / DebugCycleCountersFront[i].hitCount);
+					const int indentation = min((int)stats.depth * 2, 16);
+					ImGui::Text(" - %*s%-*s: %8.3f ms | %5u hits | %8.4f ms/hit",
+						indentation, "", 24 - indentation, stats.name,
+						stats.milliseconds,
+						stats.hitCount,
+						stats.milliseconds / stats.hitCount);
 				}
 			}
 			ImGui::PopStyleColor();
@@ -0,0 +1,238 @@
+#include "Networks.h"
+#include "NetworkSimulator.h"
+
+void NetworkSimulator::reset(uint32 seed)
+{
+	// NOTE: The generator needs seeds larger than 127
+	random = RandomNumberGenerator(max(seed, 128u));
+	badState = false;
+	linkFreeTime = 0.0;
+
+	freeCount = 0;
+	for (uint32 i = MAX_PACKETS; i > 0; --i)
+	{
+		freePackets[freeCount++] = (uint16)(i - 1);
+	}
+	pendingCount = 0;
+	nextOrder = 0;
+
+	packetsEnqueued = 0;
+	packetsLost = 0;
+	packetsOverflowed = 0;
+	packetsDuplicated = 0;
+	packetsReordered = 0;
+}
+
+void NetworkSimulator::enqueue(const char *data, uint32 size, const sockaddr_in &address, double time)
+{
+	// NOTE: The same amount of random numbers is taken for every packet,
+	// so enabling one condition doesn't change the decisions of the rest
+	const float transitionChance = random.next();
+	const float lossChance = random.next();
+	const float jitterFactor = 2.0f * random.next() - 1.0f; // from -1 to 1
+	const float duplicateChance = random.next();
+	const float duplicateJitterFactor = 2.0f * random.next() - 1.0f;
+	const float reorderChance = random.next();
+
+	packetsEnqueued++;
+
+	const NetworkConditions &c = conditions;
+
+	// Loss
+	if (c.simulateBurstLoss)
+	{
+		badState = badState ? (transitionChance >= c.badToGoodRatio) : (transitionChance < c.goodToBadRatio);
+	}
+	else
+	{
+		badState = false;
+	}
+
+	const float lossRatio = badState ? c.lossRatioBad : c.lossRatioGood;
+	if (c.simulateLoss && lossChance < lossRatio)
+	{
+		packetsLost++;
+		return;
+	}
+
+	// Bandwidth and queueing
+	double sentTime = time;
+	if (c.simulateBandwidth && c.bandwidthKBps > 0.0f)
+	{
+		const double startTime = max(time, linkFreeTime);
+		if (startTime - time > c.maxQueueDelay)
+		{
+			packetsOverflowed++;
+			return;
+		}
+
+		sentTime = startTime + size / (c.bandwidthKBps * 1024.0);
+		linkFreeTime = sentTime;
+	}
+
+	// Latency and reordering
+	double deliveryTime = sentTime;
+	if (c.simulateLatency)
+	{
+		deliveryTime += max(c.latency + c.jitter * jitterFactor, 0.0f);
+	}
+
+	if (c.simulateReordering && reorderChance < c.reorderRatio)
+	{
+		deliveryTime += c.reorderDelay;
+		packetsReordered++;
+	}
+
+	push(data, size, address, deliveryTime);
+
+	// Duplication, the copy gets its own jitter
+	if (c.simulateDuplicates && duplicateChance < c.duplicateRatio)
+	{
+		double duplicateTime = sentTime;
+		if (c.simulateLatency)
+		{
+			duplicateTime += max(c.latency + c.jitter * duplicateJitterFactor, 0.0f);
+		}
+
+		push(data, size, address, duplicateTime);
+		packetsDuplicated++;
+	}
+}
+
+void NetworkSimulator::push(const char *data, uint32 size, const sockaddr_in &address, double deliveryTime)
+{
+	ASSERT(size <= DEFAULT_PACKET_SIZE);
+
+	if (freeCount == 0)
+	{
+		// NOTE: Like a router with its buffers full
+		packetsOverflowed++;
+		return;
+	}
+
+	const uint16 index = freePackets[--freeCount];
+	Packet &packet = packets[index];
+	memcpy(packet.data, data, size);
+	packet.size = size;
+	packet.address = address;
+	packet.deliveryTime = deliveryTime;
+	packet.order = nextOrder++;
+
+	heap[pendingCount] = index;
+	siftUp(pendingCount++);
+}
+
+const NetworkSimulator::Packet *NetworkSimulator::front(double time) const
+{
+	if (pendingCount == 0) return nullptr;
+	const Packet &packet = packets[heap[0]];
+	return (packet.deliveryTime <= time) ? &packet : nullptr;
+}
+
+void NetworkSimulator::pop()
+{
+	ASSERT(pendingCount > 0);
+
+	freePackets[freeCount++] = heap[0];
+	heap[0] = heap[--pendingCount];
+	if (pendingCount > 0)
+	{
+		siftDown(0);
+	}
+}
+
+bool NetworkSimulator::less(uint16 a, uint16 b) const
+{
+	const Packet &packetA = packets[a];
+	const Packet &packetB = packets[b];
+	if (packetA.deliveryTime != packetB.deliveryTime)
+	{
+		return packetA.deliveryTime < packetB.deliveryTime;
+	}
+	return (int32)(packetA.order - packetB.order) < 0;
+}
+
+void NetworkSimulator::siftUp(uint32 position)
+{
+	while (position > 0)
+	{
+		const uint32 parent = (position - 1) / 2;
+		if (!less(heap[position], heap[parent])) break;
+		std::swap(heap[position], heap[parent]);
+		position = parent;
+	}
+}
+
+void NetworkSimulator::siftDown(uint32 position)
+{
+	for (;;)
+	{
+		const uint32 left = 2 * position + 1;
+		const uint32 right = left + 1;
+		uint32 smallest = position;
+		if (left < pendingCount && less(heap[left], heap[smallest])) smallest = left;
+		if (right < pendingCount && less(heap[right], heap[smallest])) smallest = right;
+		if (smallest == position) break;
+		std::swap(heap[position], heap[smallest]);
+		position = smallest;
+	}
+}
+
+void NetworkSimulator::gui(const char *label)
+{
+	ImGui::PushID(label);
+
+	NetworkConditions &c = conditions;
+
+	ImGui::Checkbox("Simulate latency / jitter", &c.simulateLatency);
+	if (c.simulateLatency)
+	{
+		ImGui::InputFloat("Max. latency (s)", &c.latency, 0.001f, 0.01f, 4);
+		ImGui::InputFloat("Max. jitter (s)", &c.jitter, 0.001f, 0.01f, 4);
+	}
+
+	ImGui::Checkbox("Simulate bandwidth", &c.simulateBandwidth);
+	if (c.simulateBandwidth)
+	{
+		ImGui::InputFloat("Bandwidth (KB/s)", &c.bandwidthKBps, 1.0f, 16.0f, 1);
+		ImGui::InputFloat("Max. queue delay (s)", &c.maxQueueDelay, 0.01f, 0.1f, 3);
+	}
+
+	ImGui::Checkbox("Simulate packet drops", &c.simulateLoss);
+	if (c.simulateLoss)
+	{
+		ImGui::InputFloat("Drop ratio", &c.lossRatioGood, 0.01f, 0.1f, 4);
+		ImGui::Checkbox("Burst drops", &c.simulateBurstLoss);
+		if (c.simulateBurstLoss)
+		{
+			ImGui::InputFloat("Burst drop ratio", &c.lossRatioBad, 0.01f, 0.1f, 4);
+			ImGui::InputFloat("Burst start chance", &c.goodToBadRatio, 0.01f, 0.1f, 4);
+			ImGui::InputFloat("Burst end chance", &c.badToGoodRatio, 0.01f, 0.1f, 4);
+		}
+	}
+
+	ImGui::Checkbox("Simulate duplicates", &c.simulateDuplicates);
+	if (c.simulateDuplicates)
+	{
+		ImGui::InputFloat("Duplicate ratio", &c.duplicateRatio, 0.01f, 0.1f, 4);
+	}
+
+	ImGui::Checkbox("Simulate reordering", &c.simulateReordering);
+	if (c.simulateReordering)
+	{
+		ImGui::InputFloat("Reorder ratio", &c.reorderRatio, 0.01f, 0.1f, 4);
+		ImGui::InputFloat("Reorder delay (s)", &c.reorderDelay, 0.01f, 0.1f, 3);
+	}
+
+	if (ImGui::Button("Reset to defaults"))
+	{
+		c = NetworkConditions();
+	}
+
+	ImGui::Text(" # Packets: %u", packetsEnqueued);
+	ImGui::Text(" # Dropped: %u (+%u queue full)", packetsLost, packetsOverflowed);
+	ImGui::Text(" # Duplicated: %u  Reordered: %u", packetsDuplicated, packetsReordered);
+	ImGui::Text(" Buffer usage: %d%%", 100 * pendingCount / MAX_PACKETS);
+
+	ImGui::PopID();
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+// NOTE: Emulation of one direction of a network link, to test the game
+// under bad conditions. Every decision (losses, jitter, duplicates...) is
+// taken from a seeded random generator in the order packets are enqueued,
+// so the same seed and the same traffic give the same results.
+// - Bandwidth: packets are serialized one after the other at the given
+//   rate, and wait in a queue meanwhile (dropped if it gets too long).
+// - Loss: Gilbert-Elliott model, a good and a bad (bursty) state with
+//   their own loss ratios and the chances to switch between them.
+// - Duplication and reordering: copies of a packet, and packets held back
+//   for a while so that the ones sent later overtake them.
+// Pending packets are kept in a binary heap ordered by delivery time.
+
+struct NetworkConditions
+{
+	bool simulateLatency = false;
+	float latency = 0.07f;
+	float jitter = 0.03f;
+
+	bool simulateBandwidth = false;
+	float bandwidthKBps = 64.0f;
+	float maxQueueDelay = 0.25f; // Seconds a packet can wait to be sent
+
+	bool simulateLoss = false;
+	float lossRatioGood = 0.01f;
+	bool simulateBurstLoss = false;
+	float lossRatioBad = 0.5f;
+	float goodToBadRatio = 0.02f; // Chance to enter the bad state, per packet
+	float badToGoodRatio = 0.25f; // Chance to leave the bad state, per packet
+
+	bool simulateDuplicates = false;
+	float duplicateRatio = 0.01f;
+
+	bool simulateReordering = false;
+	float reorderRatio = 0.02f;
+	float reorderDelay = 0.05f;
+
+	bool isEnabled() const
+	{
+		return simulateLatency || simulateBandwidth || simulateLoss || simulateDuplicates || simulateReordering;
+	}
+};
+
+class NetworkSimulator
+{
+public:
+
+	static const int MAX_PACKETS = 256;
+
+	struct Packet
+	{
+		char data[DEFAULT_PACKET_SIZE];
+		uint32 size;
+		sockaddr_in address;
+		double deliveryTime;
+		uint32 order; // Ties of delivery time keep the enqueue order
+	};
+
+	NetworkConditions conditions;
+
+	NetworkSimulator() { reset(987654321); }
+
+	// Drops all the pending packets and restarts the random sequence
+	void reset(uint32 seed);
+
+	bool isEnabled() const { return conditions.isEnabled(); }
+	bool hasPendingPackets() const { return pendingCount > 0; }
+
+	void enqueue(const char *data, uint32 size, const sockaddr_in &address, double time);
+
+	// Next packet to be delivered at the given time, if any, to be
+	// released with pop() once processed
+	const Packet *front(double time) const;
+	void pop();
+
+	void gui(const char *label);
+
+	// Stats
+	uint32 packetsEnqueued = 0;
+	uint32 packetsLost = 0;
+	uint32 packetsOverflowed = 0;
+	uint32 packetsDuplicated = 0;
+	uint32 packetsReordered = 0;
+
+private:
+
+	void push(const char *data, uint32 size, const sockaddr_in &address, double deliveryTime);
+	bool less(uint16 a, uint16 b) const;
+	void siftUp(uint32 position);
+	void siftDown(uint32 position);
+
+	Packet packets[MAX_PACKETS];
+	uint16 freePackets[MAX_PACKETS];
+	uint32 freeCount = 0;
+	uint16 heap[MAX_PACKETS];
+	uint32 pendingCount = 0;
+	uint32 nextOrder = 0;
+
+	RandomNumberGenerator random;
+	bool badState = false;
+	double linkFreeTime = 0.0; // When the link has sent all the queued bytes
+};
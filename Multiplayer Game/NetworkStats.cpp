@@ -0,0 +1,369 @@
+#include "Networks.h"
+#include "NetworkStats.h"
+
+
+//////////////////////////////////////////////////////////////////////
+// Counters
+//////////////////////////////////////////////////////////////////////
+
+void RollingRate::sample(uint64 total)
+{
+	if (sampleCount == ArrayCount(samples))
+	{
+		memmove(samples, samples + 1, sizeof(samples) - sizeof(samples[0]));
+		sampleCount--;
+	}
+	samples[sampleCount++] = total;
+}
+
+double RollingRate::perSecond() const
+{
+	if (sampleCount < 2) return 0.0;
+	return (double)(samples[sampleCount - 1] - samples[0]) / (double)(sampleCount - 1);
+}
+
+const uint32 RttHistogram::BUCKET_LIMITS_MS[RttHistogram::BUCKET_COUNT - 1] = { 10, 25, 50, 100, 200, 400, 800 };
+
+void RttHistogram::addSample(double seconds)
+{
+	const uint64 microseconds = (uint64)(max(seconds, 0.0) * 1000000.0);
+
+	int bucket = 0;
+	while (bucket < BUCKET_COUNT - 1 && microseconds >= BUCKET_LIMITS_MS[bucket] * 1000ull)
+	{
+		bucket++;
+	}
+
+	buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+	sampleCount.fetch_add(1, std::memory_order_relaxed);
+	totalMicroseconds.fetch_add(microseconds, std::memory_order_relaxed);
+}
+
+double RttHistogram::averageMilliseconds() const
+{
+	const uint32 count = sampleCount.load(std::memory_order_relaxed);
+	if (count == 0) return 0.0;
+	return totalMicroseconds.load(std::memory_order_relaxed) / 1000.0 / count;
+}
+
+void RttHistogram::reset()
+{
+	for (auto &bucket : buckets) bucket = 0;
+	sampleCount = 0;
+	totalMicroseconds = 0;
+}
+
+void ConnectionStats::reset()
+{
+	used = false;
+	address = {};
+	sent.reset();
+	received.reset();
+	sentRate.reset();
+	receivedRate.reset();
+	deliveriesAcked = 0;
+	deliveriesResent = 0;
+	rtt.reset();
+}
+
+
+//////////////////////////////////////////////////////////////////////
+// NetworkStats
+//////////////////////////////////////////////////////////////////////
+
+static bool sameAddress(const sockaddr_in &a, const sockaddr_in &b)
+{
+	return a.sin_addr.S_un.S_addr == b.sin_addr.S_un.S_addr && a.sin_port == b.sin_port;
+}
+
+// Message type of a packet, right after the protocol id
+static int packetMessageType(const char *data, uint32 size)
+{
+	uint32 protocolId;
+	if (size < sizeof(protocolId) + 1) return -1;
+	memcpy(&protocolId, data, sizeof(protocolId));
+	if (protocolId != PROTOCOL_ID) return -1;
+	return (uint8)data[sizeof(protocolId)];
+}
+
+static const char *messageTypeName(bool sentByServer, int type)
+{
+	return sentByServer ? serverMessageName((ServerMessage)type) : clientMessageName((ClientMessage)type);
+}
+
+static void addressToString(const sockaddr_in &address, char *string, size_t size)
+{
+	char addressStr[64];
+	inet_ntop(AF_INET, (void*)&address.sin_addr, addressStr, sizeof(addressStr));
+	sprintf_s(string, size, "%s:%d", addressStr, ntohs(address.sin_port));
+}
+
+void NetworkStats::reset()
+{
+	sent.reset();
+	received.reset();
+	for (auto &counters : sentByMessage) counters.reset();
+	for (auto &counters : receivedByMessage) counters.reset();
+	for (auto &counters : replicationByObjectType) counters.reset();
+	for (auto &connection : connections) connection.reset();
+	sentRate.reset();
+	receivedRate.reset();
+	lastSampleTime = Time.time;
+	lastDumpTime = Time.time;
+}
+
+void NetworkStats::update(bool isServer)
+{
+	if (Time.time - lastSampleTime >= 1.0)
+	{
+		lastSampleTime = Time.time;
+
+		sentRate.sample(sent.bytes);
+		receivedRate.sample(received.bytes);
+		for (auto &connection : connections)
+		{
+			if (connection.used)
+			{
+				connection.sentRate.sample(connection.sent.bytes);
+				connection.receivedRate.sample(connection.received.bytes);
+			}
+		}
+	}
+
+	if (dumpToFile && Time.time - lastDumpTime >= dumpIntervalSeconds)
+	{
+		lastDumpTime = Time.time;
+		writeToFile(isServer ? "netstats_server.json" : "netstats_client.json", isServer);
+	}
+}
+
+void NetworkStats::onPacketSent(const sockaddr_in &address, const char *data, uint32 size)
+{
+	sent.add(size);
+
+	const int type = packetMessageType(data, size);
+	if (type >= 0 && type < MAX_MESSAGE_TYPES)
+	{
+		sentByMessage[type].add(size);
+	}
+
+	ConnectionStats *connection = findConnection(address);
+	if (connection != nullptr)
+	{
+		connection->sent.add(size);
+	}
+}
+
+void NetworkStats::onPacketReceived(const sockaddr_in &address, const char *data, uint32 size)
+{
+	received.add(size);
+
+	const int type = packetMessageType(data, size);
+	if (type >= 0 && type < MAX_MESSAGE_TYPES)
+	{
+		receivedByMessage[type].add(size);
+	}
+
+	ConnectionStats *connection = findConnection(address);
+	if (connection != nullptr)
+	{
+		connection->received.add(size);
+	}
+}
+
+ConnectionStats *NetworkStats::addConnection(const sockaddr_in &address)
+{
+	ConnectionStats *connection = findConnection(address);
+	if (connection != nullptr)
+	{
+		return connection;
+	}
+
+	for (auto &freeConnection : connections)
+	{
+		if (!freeConnection.used)
+		{
+			freeConnection.used = true;
+			freeConnection.address = address;
+			return &freeConnection;
+		}
+	}
+
+	WLOG("NetworkStats::addConnection() - no free connection slots");
+	return nullptr;
+}
+
+ConnectionStats *NetworkStats::findConnection(const sockaddr_in &address)
+{
+	// NOTE: Unknown sources (e.g. refused or unverified clients) are only
+	// counted in the totals
+	for (auto &connection : connections)
+	{
+		if (connection.used && sameAddress(connection.address, address))
+		{
+			return &connection;
+		}
+	}
+	return nullptr;
+}
+
+void NetworkStats::closeConnection(const sockaddr_in &address)
+{
+	for (auto &connection : connections)
+	{
+		if (connection.used && sameAddress(connection.address, address))
+		{
+			connection.reset();
+		}
+	}
+}
+
+void NetworkStats::addReplicatedObject(uint8 objectType, uint32 size)
+{
+	if (objectType < MAX_OBJECT_TYPES)
+	{
+		replicationByObjectType[objectType].add(size);
+	}
+}
+
+void NetworkStats::gui(bool isServer)
+{
+	ImGui::Text(" - Sent: %llu packets, %llu bytes (%.1f KB/s)",
+		(uint64)sent.count, (uint64)sent.bytes, sentRate.perSecond() / 1024.0);
+	ImGui::Text(" - Received: %llu packets, %llu bytes (%.1f KB/s)",
+		(uint64)received.count, (uint64)received.bytes, receivedRate.perSecond() / 1024.0);
+
+	if (ImGui::CollapsingHeader("Network stats"))
+	{
+		ImGui::Checkbox("Dump to file", &dumpToFile);
+
+		ImGui::Text("Messages sent");
+		for (int i = 0; i < MAX_MESSAGE_TYPES; ++i)
+		{
+			if (sentByMessage[i].count > 0)
+			{
+				ImGui::Text("   %-12s %8llu packets %10llu bytes", messageTypeName(isServer, i),
+					(uint64)sentByMessage[i].count, (uint64)sentByMessage[i].bytes);
+			}
+		}
+
+		ImGui::Text("Messages received");
+		for (int i = 0; i < MAX_MESSAGE_TYPES; ++i)
+		{
+			if (receivedByMessage[i].count > 0)
+			{
+				ImGui::Text("   %-12s %8llu packets %10llu bytes", messageTypeName(!isServer, i),
+					(uint64)receivedByMessage[i].count, (uint64)receivedByMessage[i].bytes);
+			}
+		}
+
+		if (isServer)
+		{
+			ImGui::Text("Replication by object type");
+			for (int i = 0; i < MAX_OBJECT_TYPES; ++i)
+			{
+				if (replicationByObjectType[i].count > 0)
+				{
+					ImGui::Text("   %-22s %8llu objects %10llu bytes", behaviourTypeName((BehaviourType)i),
+						(uint64)replicationByObjectType[i].count, (uint64)replicationByObjectType[i].bytes);
+				}
+			}
+		}
+
+		for (auto &connection : connections)
+		{
+			if (!connection.used) continue;
+
+			char addressStr[64];
+			addressToString(connection.address, addressStr, sizeof(addressStr));
+			ImGui::Text("Connection %s", addressStr);
+			ImGui::Text("   Out: %.1f KB/s  In: %.1f KB/s", connection.sentRate.perSecond() / 1024.0, connection.receivedRate.perSecond() / 1024.0);
+			ImGui::Text("   Acks: %u  Resends: %u  RTT: %.1f ms", (uint32)connection.deliveriesAcked, (uint32)connection.deliveriesResent, connection.rtt.averageMilliseconds());
+		}
+	}
+}
+
+static void writeTraffic(FILE *f, const char *name, const TrafficCounters &counters, const RollingRate *rate)
+{
+	fprintf(f, "\"%s\":{\"count\":%llu,\"bytes\":%llu", name, (uint64)counters.count, (uint64)counters.bytes);
+	if (rate != nullptr) fprintf(f, ",\"bytesPerSecond\":%.1f", rate->perSecond());
+	fprintf(f, "}");
+}
+
+bool NetworkStats::writeToFile(const char *filename, bool isServer) const
+{
+	FILE *f = fopen(filename, "w");
+	if (f == nullptr)
+	{
+		WLOG("NetworkStats::writeToFile() - could not open %s", filename);
+		return false;
+	}
+
+	fprintf(f, "{\"time\":%.3f,\"role\":\"%s\",\n", Time.time, isServer ? "server" : "client");
+	writeTraffic(f, "sent", sent, &sentRate);
+	fprintf(f, ",\n");
+	writeTraffic(f, "received", received, &receivedRate);
+
+	fprintf(f, ",\n\"messagesSent\":{");
+	bool first = true;
+	for (int i = 0; i < MAX_MESSAGE_TYPES; ++i)
+	{
+		if (sentByMessage[i].count == 0) continue;
+		fprintf(f, first ? "" : ",");
+		writeTraffic(f, messageTypeName(isServer, i), sentByMessage[i], nullptr);
+		first = false;
+	}
+
+	fprintf(f, "},\n\"messagesReceived\":{");
+	first = true;
+	for (int i = 0; i < MAX_MESSAGE_TYPES; ++i)
+	{
+		if (receivedByMessage[i].count == 0) continue;
+		fprintf(f, first ? "" : ",");
+		writeTraffic(f, messageTypeName(!isServer, i), receivedByMessage[i], nullptr);
+		first = false;
+	}
+
+	fprintf(f, "},\n\"replicationByObjectType\":{");
+	first = true;
+	for (int i = 0; i < MAX_OBJECT_TYPES; ++i)
+	{
+		if (replicationByObjectType[i].count == 0) continue;
+		fprintf(f, first ? "" : ",");
+		writeTraffic(f, behaviourTypeName((BehaviourType)i), replicationByObjectType[i], nullptr);
+		first = false;
+	}
+
+	fprintf(f, "},\n\"connections\":[");
+	first = true;
+	for (const auto &connection : connections)
+	{
+		if (!connection.used) continue;
+
+		char addressStr[64];
+		addressToString(connection.address, addressStr, sizeof(addressStr));
+		fprintf(f, "%s\n{\"address\":\"%s\",", first ? "" : ",", addressStr);
+		writeTraffic(f, "sent", connection.sent, &connection.sentRate);
+		fprintf(f, ",");
+		writeTraffic(f, "received", connection.received, &connection.receivedRate);
+		fprintf(f, ",\"deliveriesAcked\":%u,\"deliveriesResent\":%u",
+			(uint32)connection.deliveriesAcked, (uint32)connection.deliveriesResent);
+		fprintf(f, ",\"rtt\":{\"samples\":%u,\"averageMs\":%.2f,\"bucketLimitsMs\":[",
+			(uint32)connection.rtt.sampleCount, connection.rtt.averageMilliseconds());
+		for (int b = 0; b < RttHistogram::BUCKET_COUNT - 1; ++b)
+		{
+			fprintf(f, "%s%u", b == 0 ? "" : ",", RttHistogram::BUCKET_LIMITS_MS[b]);
+		}
+		fprintf(f, "],\"histogram\":[");
+		for (int b = 0; b < RttHistogram::BUCKET_COUNT; ++b)
+		{
+			fprintf(f, "%s%u", b == 0 ? "" : ",", (uint32)connection.rtt.buckets[b]);
+		}
+		fprintf(f, "]}}");
+		first = false;
+	}
+	fprintf(f, "\n]}\n");
+
+	fclose(f);
+	return true;
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+// NOTE: Network counters of a client or server. All of them are relaxed
+// atomics that are only ever added to, as some are updated from the task
+// manager threads (replication packets, delivery timeouts). The main thread
+// samples the totals once per second to compute rates over a rolling
+// window, and periodically dumps everything to a JSON file so that it can
+// be inspected without the GUI.
+
+struct TrafficCounters
+{
+	std::atomic<uint64> count{ 0 };
+	std::atomic<uint64> bytes{ 0 };
+
+	void add(uint64 size)
+	{
+		count.fetch_add(1, std::memory_order_relaxed);
+		bytes.fetch_add(size, std::memory_order_relaxed);
+	}
+
+	void reset() { count = 0; bytes = 0; }
+};
+
+// Bytes per second over the last samples of a growing total
+class RollingRate
+{
+public:
+
+	static const int WINDOW_SECONDS = 10;
+
+	void sample(uint64 total);
+	double perSecond() const;
+	void reset() { sampleCount = 0; }
+
+private:
+
+	uint64 samples[WINDOW_SECONDS + 1] = {};
+	uint32 sampleCount = 0;
+};
+
+class RttHistogram
+{
+public:
+
+	static const int BUCKET_COUNT = 8;
+	static const uint32 BUCKET_LIMITS_MS[BUCKET_COUNT - 1]; // Upper limits, the last bucket has none
+
+	void addSample(double seconds);
+	double averageMilliseconds() const;
+	void reset();
+
+	std::atomic<uint32> buckets[BUCKET_COUNT] = {};
+	std::atomic<uint32> sampleCount{ 0 };
+	std::atomic<uint64> totalMicroseconds{ 0 };
+};
+
+struct ConnectionStats
+{
+	bool used = false;
+	sockaddr_in address = {};
+
+	TrafficCounters sent;
+	TrafficCounters received;
+	RollingRate sentRate;
+	RollingRate receivedRate;
+
+	// Reliable deliveries (sender side)
+	std::atomic<uint32> deliveriesAcked{ 0 };
+	std::atomic<uint32> deliveriesResent{ 0 };
+	RttHistogram rtt;
+
+	void reset();
+};
+
+class NetworkStats
+{
+public:
+
+	static const int MAX_MESSAGE_TYPES = 16;
+	static const int MAX_OBJECT_TYPES = 16;
+	static const int MAX_CONNECTIONS = MAX_CLIENTS + 1;
+
+	void reset();
+
+	// Main thread, once per frame
+	void update(bool isServer);
+
+	void onPacketSent(const sockaddr_in &address, const char *data, uint32 size);
+	void onPacketReceived(const sockaddr_in &address, const char *data, uint32 size);
+
+	// Stats of the connection with an address. Only added for accepted
+	// connections, so that stray senders don't take the slots. Main
+	// thread only, the returned pointer stays valid until closed.
+	ConnectionStats *addConnection(const sockaddr_in &address);
+	ConnectionStats *findConnection(const sockaddr_in &address);
+	void closeConnection(const sockaddr_in &address);
+
+	// Any thread
+	void addReplicatedObject(uint8 objectType, uint32 size);
+
+	void gui(bool isServer);
+
+	bool writeToFile(const char *filename, bool isServer) const;
+
+	TrafficCounters sent;
+	TrafficCounters received;
+	TrafficCounters sentByMessage[MAX_MESSAGE_TYPES];
+	TrafficCounters receivedByMessage[MAX_MESSAGE_TYPES];
+	TrafficCounters replicationByObjectType[MAX_OBJECT_TYPES];
+	ConnectionStats connections[MAX_CONNECTIONS];
+
+	RollingRate sentRate;
+	RollingRate receivedRate;
+
+	bool dumpToFile = true;
+	float dumpIntervalSeconds = 5.0f;
+
+private:
+
+	double lastSampleTime = 0.0;
+	double lastDumpTime = 0.0;
+};
@@ -12,7 +12,9 @@
 #ifdef ASSERT
 #undef ASSERT
 #endif
-#define ASSERT(x) if ((x) == false) { *(int*)0 = 0; }
+// NOTE: The pending log messages are written before crashing on purpose
+void flushLogOnCrash();
+#define ASSERT(x) if ((x) == false) { flushLogOnCrash(); *(int*)0 = 0; }
 
 #define Kilobytes(x) (1024L * x)
 #define Megabytes(x) (1024L * Kilobytes(x))
@@ -28,14 +30,22 @@
 
 #define MAX_LOG_ENTRIES                                  256
 #define MAX_LOG_ENTRY_LENGTH                    Kilobytes(1)
+#define MAX_LOG_RECORDS                                 1024
+#define MAX_LOG_ARGS_SIZE                                256
+#define MAX_PROFILE_BLOCKS                               256
+#define MAX_PROFILE_THREADS             (MAX_TASK_THREADS + 4)
+#define MAX_PROFILE_EVENTS                              8192
 #define MAX_SCREENS                                       32
 #define MAX_ANIMATION_CLIPS                                8
 #define MAX_TASKS                                        128
+#define MAX_TASK_THREADS                                  32
+#define MAX_TASK_DEPENDENTS                                8
 #define MAX_TEXTURES                                     512
 #define MAX_GAME_OBJECTS                                4096
 #define MAX_COLLIDERS                       MAX_GAME_OBJECTS
 #define MAX_CLIENTS                                       20
 #define MAX_NETWORK_OBJECTS                              256
+#define MAX_TIMERS                          MAX_GAME_OBJECTS
 
 #define SCENE_TRANSITION_TIME_SECONDS                   1.0f
 #define DISCONNECT_TIMEOUT_SECONDS                      5.0f
@@ -43,6 +53,7 @@
 #define DEFAULT_PACKET_SIZE                     Kilobytes(4)
 #define PING_INTERVAL_SECONDS                           0.5f
 #define REPLICATION_INTERVAL_SECONDS					0.2f
+#define TIMER_WHEEL_TICK_SECONDS                        0.01
 
 
 ////////////////////////////////////////////////////////////////////////
@@ -184,6 +195,12 @@ extern MouseController Mouse;
 // Use log just like standard printf function.
 // Example: LOG("New user connected %s\n", usernameString);
 
+// NOTE: Logging only copies the arguments into a lock-free queue, so it
+// can be used from any thread. The messages are formatted and written to
+// the log file and to the log history in a thread of their own. Errors
+// are the exception, they drain the queue in the calling thread, so they
+// are in the log file even if the process dies right after them.
+
 enum { LOG_TYPE_INFO, LOG_TYPE_WARN, LOG_TYPE_ERROR, LOG_TYPE_DEBUG };
 
 struct LogEntry {
@@ -192,63 +209,42 @@ struct LogEntry {
 	char message[MAX_LOG_ENTRY_LENGTH];
 };
 
-void log(const char file[], int line, int type, const char* format, ...);
+bool startLogThread(const char *filename);
+void stopLogThread();
+void flushLog();
 LogEntry getLogEntry(uint32 entryIndex);
 uint32 getLogEntryCount();
 void clearLogEntries();
 
+// Messages with less severity than LOG_MIN_LEVEL are compiled out
+#define LOG_LEVEL_DEBUG 0
+#define LOG_LEVEL_INFO  1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_ERROR 3
+
+#if !defined(LOG_MIN_LEVEL)
+#define LOG_MIN_LEVEL LOG_LEVEL_DEBUG
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_INFO
 #define LOG(format, ...)  log(__FILE__, __LINE__, LOG_TYPE_INFO,  format, __VA_ARGS__)
+#else
+#define LOG(format, ...)  ((void)0)
+#endif
+#if LOG_MIN_LEVEL <= LOG_LEVEL_WARN
 #define WLOG(format, ...) log(__FILE__, __LINE__, LOG_TYPE_WARN,  format, __VA_ARGS__)
+#else
+#define WLOG(format, ...) ((void)0)
+#endif
+#if LOG_MIN_LEVEL <= LOG_LEVEL_ERROR
 #define ELOG(format, ...) log(__FILE__, __LINE__, LOG_TYPE_ERROR, format, __VA_ARGS__)
+#else
+#define ELOG(format, ...) ((void)0)
+#endif
+#if LOG_MIN_LEVEL <= LOG_LEVEL_DEBUG
 #define DLOG(format, ...) log(__FILE__, __LINE__, LOG_TYPE_DEBUG, format, __VA_ARGS__)
-
-
-
-////////////////////////////////////////////////////////////////////////
-// PROFILER
-////////////////////////////////////////////////////////////////////////
-
-enum DebugCycleCounterID
-{
-	DebugCycleCounter_Frame,
-	DebugCycleCounter_PreUpdate,
-	DebugCycleCounter_Update,
-	DebugCycleCounter_PostUpdate,
-	DebugCycleCounter_GuiUpdate,
-	DebugCycleCounter_GOUpdate,
-	DebugCycleCounter_GOPreUpdate,
-	DebugCycleCounter_Collisions,
-	DebugCycleCounter_Collisions1,
-	DebugCycleCounter_Collisions2,
-	DebugCycleCounter_CollisionTest,
-	DebugCycleCounter_NetSend,
-	DebugCycleCounter_NetRecv,
-	DebugCycleCounter_Render,
-	DebugCycleCounter_Count
-};
-
-struct DebugCycleCounter
-{
-	uint64 cycleCount = 0;
-	uint32 hitCount = 0;
-	const char *label = "";
-};
-
-extern DebugCycleCounter DebugCycleCountersBack[DebugCycleCounter_Count];
-extern DebugCycleCounter DebugCycleCountersFront[DebugCycleCounter_Count];
-void DebugSwapCycleCounters();
-
-#if _MSC_VER
-#define BEGIN_TIMED_BLOCK(ID) uint64 beginCycleCount##ID = __rdtsc();
-#define END_TIMED_BLOCK(ID) \
-	DebugCycleCountersBack[DebugCycleCounter_##ID].label = #ID; \
-	DebugCycleCountersBack[DebugCycleCounter_##ID].cycleCount += __rdtsc() - beginCycleCount##ID; \
-	DebugCycleCountersBack[DebugCycleCounter_##ID].hitCount++;
-#define END_PROFILING_FRAME() DebugSwapCycleCounters()
 #else
-#define BEGIN_TIMED_BLOCK(ID)
-#define END_TIMED_BLOCK(ID)
-#define END_PROFILING_FRAME()
+#define DLOG(format, ...) ((void)0)
 #endif
 
 
@@ -314,15 +310,24 @@ extern RandomNumberGenerator Random;
 // FRAMEWORK HEADERS
 ////////////////////////////////////////////////////////////////////////
 
+#include "Log.h"
+#include "Profiler.h"
 #include "Maths.h"
 #include "Messages.h"
 #include "ByteSwap.h"
 #include "MemoryStream.h"
+#include "NetworkStats.h"
+#include "NetworkSimulator.h"
+#include "ConnectionGuard.h"
+#include "MessageChannels.h"
+#include "GameEvents.h"
 #include "DeliveryManager.h"
+#include "TimerWheel.h"
 #include "ReplicationCommand.h"
 #include "ReplicationManagerClient.h"
 #include "ReplicationManagerServer.h"
 #include "Module.h"
+#include "ModuleTaskManager.h"
 #include "ModuleNetworking.h"
 #include "ModuleNetworkingCommons.h"
 #include "ModuleNetworkingClient.h"
@@ -332,8 +337,11 @@ extern RandomNumberGenerator Random;
 #include "ModuleCollision.h"
 #include "ModuleBehaviour.h"
 #include "ModulePlatform.h"
+#include "SpriteBatch.h"
 #include "ModuleRender.h"
-#include "ModuleTaskManager.h"
+#include "MappedFile.h"
+#include "AssetCache.h"
+#include "TextureAtlas.h"
 #include "ModuleResources.h"
 #include "ModuleScreen.h"
 #include "ModuleSound.h"
@@ -0,0 +1,281 @@
+#include "Networks.h"
+#include "Profiler.h"
+
+
+//////////////////////////////////////////////////////////////////////
+// Threads and blocks
+//////////////////////////////////////////////////////////////////////
+
+struct ProfileEvent
+{
+	uint64 begin;
+	uint64 end;
+	uint32 block;
+	uint32 depth;
+};
+
+// NOTE: Written only by its own thread. The main thread reads the stats
+// (relaxed atomics, they are just counters) and the events of a capture
+// (up to the write count it observes).
+struct ProfileThread
+{
+	char name[32] = {};
+	uint32 index = 0;
+	uint32 depth = 0;
+
+	std::atomic<uint64> blockTime[MAX_PROFILE_BLOCKS] = {};
+	std::atomic<uint32> blockHits[MAX_PROFILE_BLOCKS] = {};
+
+	// Ring of events, only recorded while capturing
+	ProfileEvent events[MAX_PROFILE_EVENTS];
+	std::atomic<uint64> eventWriteCount{ 0 };
+	uint64 captureBeginCount = 0;
+};
+
+static ProfileThread *profileThreads[MAX_PROFILE_THREADS] = {};
+static std::atomic<uint32> profileThreadCount{ 0 };
+static thread_local ProfileThread *currentProfileThread = nullptr;
+
+static ProfileBlock *profileBlocks[MAX_PROFILE_BLOCKS] = {};
+static std::atomic<uint32> profileBlockCount{ 0 };
+
+static ProfileThread *getProfileThread()
+{
+	if (currentProfileThread == nullptr)
+	{
+		const uint32 index = profileThreadCount.load();
+		if (index >= MAX_PROFILE_THREADS)
+		{
+			return nullptr;
+		}
+
+		ProfileThread *thread = new ProfileThread;
+		thread->index = profileThreadCount.fetch_add(1);
+		if (thread->index >= MAX_PROFILE_THREADS)
+		{
+			delete thread;
+			return nullptr;
+		}
+
+		sprintf_s(thread->name, sizeof(thread->name), "Thread %u", thread->index);
+		profileThreads[thread->index] = thread;
+		currentProfileThread = thread;
+	}
+
+	return currentProfileThread;
+}
+
+ProfileBlock::ProfileBlock(const char *name, const char *file, int line) :
+	name(name), file(file), line(line)
+{
+	ProfileThread *thread = getProfileThread();
+	depth = (thread != nullptr) ? thread->depth : 0;
+
+	index = profileBlockCount.fetch_add(1);
+	if (index < MAX_PROFILE_BLOCKS)
+	{
+		profileBlocks[index] = this;
+	}
+	else
+	{
+		profileBlockCount = MAX_PROFILE_BLOCKS;
+	}
+}
+
+uint64 profileTimestamp()
+{
+	return (uint64)std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static std::atomic<bool> profileCapturing{ false };
+
+ProfileScope::ProfileScope(ProfileBlock *block) : block(block)
+{
+	ProfileThread *thread = getProfileThread();
+	if (thread != nullptr) thread->depth++;
+	begin = profileTimestamp();
+}
+
+void profileRecordScope(ProfileBlock *block, uint64 begin, uint64 end)
+{
+	ProfileThread *thread = currentProfileThread;
+	if (thread == nullptr) return;
+
+	thread->depth--;
+
+	if (block->index >= MAX_PROFILE_BLOCKS) return;
+
+	thread->blockTime[block->index].fetch_add(end - begin, std::memory_order_relaxed);
+	thread->blockHits[block->index].fetch_add(1, std::memory_order_relaxed);
+
+	if (profileCapturing.load(std::memory_order_relaxed))
+	{
+		const uint64 writeCount = thread->eventWriteCount.load(std::memory_order_relaxed);
+		ProfileEvent &event = thread->events[writeCount % MAX_PROFILE_EVENTS];
+		event.begin = begin;
+		event.end = end;
+		event.block = block->index;
+		event.depth = thread->depth;
+		thread->eventWriteCount.store(writeCount + 1, std::memory_order_release);
+	}
+}
+
+void profileSetThreadName(const char *name)
+{
+	ProfileThread *thread = getProfileThread();
+	if (thread != nullptr)
+	{
+		strncpy(thread->name, name, sizeof(thread->name) - 1);
+	}
+}
+
+
+//////////////////////////////////////////////////////////////////////
+// Frames and captures
+//////////////////////////////////////////////////////////////////////
+
+struct ProfileFrameStats
+{
+	uint64 time;
+	uint32 hits;
+};
+
+static ProfileFrameStats profileFrameStats[MAX_PROFILE_BLOCKS] = {};
+
+static uint32 captureFramesLeft = 0;
+static uint32 captureFrameCount = 0;
+static uint32 captureFileCount = 0;
+static uint64 captureBeginTime = 0;
+
+static const char *profileBaseFilename(const char *file)
+{
+	const char *basefile = file;
+	for (const char *c = file; *c != '\0'; ++c) {
+		if (*c == '\\' || *c == '/') {
+			basefile = c + 1;
+		}
+	}
+	return basefile;
+}
+
+static void writeCapture()
+{
+	char filename[64];
+	sprintf_s(filename, sizeof(filename), "profile_capture_%u.json", captureFileCount++);
+
+	FILE *f = fopen(filename, "w");
+	if (f == nullptr)
+	{
+		WLOG("Could not open profile capture file %s", filename);
+		return;
+	}
+
+	fprintf(f, "{\"traceEvents\":[\n");
+
+	bool first = true;
+	const uint32 threadCount = min(profileThreadCount.load(), (uint32)MAX_PROFILE_THREADS);
+	for (uint32 t = 0; t < threadCount; ++t)
+	{
+		ProfileThread *thread = profileThreads[t];
+		if (thread == nullptr) continue;
+
+		fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+			first ? "" : ",\n", thread->index, thread->name);
+		first = false;
+
+		// NOTE: Events that didn't fit in the ring are lost, keep the newest
+		const uint64 endCount = thread->eventWriteCount.load(std::memory_order_acquire);
+		const uint64 beginCount = max(thread->captureBeginCount, endCount > MAX_PROFILE_EVENTS ? endCount - MAX_PROFILE_EVENTS : 0);
+		for (uint64 i = beginCount; i < endCount; ++i)
+		{
+			const ProfileEvent &event = thread->events[i % MAX_PROFILE_EVENTS];
+			const ProfileBlock *block = profileBlocks[event.block];
+			if (block == nullptr || event.begin < captureBeginTime) continue;
+
+			fprintf(f, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+				block->name, profileBaseFilename(block->file),
+				(event.begin - captureBeginTime) / 1000.0, (event.end - event.begin) / 1000.0, thread->index);
+		}
+	}
+
+	fprintf(f, "\n]}\n");
+	fclose(f);
+
+	LOG("Profile capture of %u frames written to %s", captureFrameCount, filename);
+}
+
+void profileEndFrame()
+{
+	const uint32 blockCount = getProfileBlockCount();
+	const uint32 threadCount = min(profileThreadCount.load(), (uint32)MAX_PROFILE_THREADS);
+
+	for (uint32 b = 0; b < blockCount; ++b)
+	{
+		profileFrameStats[b] = {};
+		for (uint32 t = 0; t < threadCount; ++t)
+		{
+			ProfileThread *thread = profileThreads[t];
+			if (thread == nullptr) continue;
+			profileFrameStats[b].time += thread->blockTime[b].exchange(0, std::memory_order_relaxed);
+			profileFrameStats[b].hits += thread->blockHits[b].exchange(0, std::memory_order_relaxed);
+		}
+	}
+
+	if (captureFramesLeft > 0)
+	{
+		if (!profileCapturing)
+		{
+			// Start capturing from the next frame on
+			captureBeginTime = profileTimestamp();
+			for (uint32 t = 0; t < threadCount; ++t)
+			{
+				if (profileThreads[t] != nullptr)
+				{
+					profileThreads[t]->captureBeginCount = profileThreads[t]->eventWriteCount.load(std::memory_order_acquire);
+				}
+			}
+			profileCapturing = true;
+		}
+		else if (--captureFramesLeft == 0)
+		{
+			profileCapturing = false;
+			writeCapture();
+		}
+	}
+}
+
+void profileRequestCapture(uint32 frameCount)
+{
+	if (captureFramesLeft == 0 && frameCount > 0)
+	{
+		captureFramesLeft = frameCount;
+		captureFrameCount = frameCount;
+	}
+}
+
+bool profileIsCapturing()
+{
+	return captureFramesLeft > 0;
+}
+
+uint32 getProfileBlockCount()
+{
+	return min(profileBlockCount.load(), (uint32)MAX_PROFILE_BLOCKS);
+}
+
+ProfileBlockStats getProfileBlockStats(uint32 blockIndex)
+{
+	ASSERT(blockIndex < getProfileBlockCount());
+
+	ProfileBlockStats stats = {};
+	const ProfileBlock *block = profileBlocks[blockIndex];
+	if (block != nullptr)
+	{
+		stats.name = block->name;
+		stats.depth = block->depth;
+		stats.hitCount = profileFrameStats[blockIndex].hits;
+		stats.milliseconds = profileFrameStats[blockIndex].time / 1000000.0;
+	}
+	return stats;
+}
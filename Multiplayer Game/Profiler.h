@@ -0,0 +1,78 @@
+#pragma once
+
+// NOTE: Comment this line to compile all the profiling scopes out
+#define USE_PROFILER
+
+// NOTE: Scoped profiler. Each PROFILE_SCOPE() registers its block the first
+// time it is entered, and measures the time until the end of the C++ scope,
+// so scopes can be nested freely and used from any thread. Time per block is
+// accumulated every frame for the UI, and captures of a few frames are
+// written in Chrome trace format (open them in chrome://tracing or
+// https://ui.perfetto.dev), with one timeline per thread.
+
+class ProfileBlock
+{
+public:
+
+	ProfileBlock(const char *name, const char *file, int line);
+
+	const char *name;
+	const char *file;
+	int line;
+	uint32 index;
+	uint32 depth; // Nesting level where it was first entered
+};
+
+uint64 profileTimestamp();
+void profileRecordScope(ProfileBlock *block, uint64 begin, uint64 end);
+
+class ProfileScope
+{
+public:
+
+	explicit ProfileScope(ProfileBlock *block);
+	~ProfileScope() { profileRecordScope(block, begin, profileTimestamp()); }
+
+private:
+
+	ProfileBlock *block;
+	uint64 begin;
+};
+
+struct ProfileBlockStats
+{
+	const char *name;
+	uint32 depth;
+	uint32 hitCount;
+	double milliseconds;
+};
+
+// To be called from each thread that profiles anything, to name its timeline
+void profileSetThreadName(const char *name);
+
+// Called once per frame by the main thread
+void profileEndFrame();
+
+// To write the next frames to a trace file
+void profileRequestCapture(uint32 frameCount);
+bool profileIsCapturing();
+
+// Times of the last frame, for the UI
+uint32 getProfileBlockCount();
+ProfileBlockStats getProfileBlockStats(uint32 blockIndex);
+
+#if defined(USE_PROFILER)
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(name) \
+	static ProfileBlock PROFILE_CONCAT(profileBlock, __LINE__)(name, __FILE__, __LINE__); \
+	ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(&PROFILE_CONCAT(profileBlock, __LINE__))
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
+#define PROFILE_THREAD_NAME(name) profileSetThreadName(name)
+#define PROFILE_END_FRAME() profileEndFrame()
+#else
+#define PROFILE_SCOPE(name)
+#define PROFILE_FUNCTION()
+#define PROFILE_THREAD_NAME(name)
+#define PROFILE_END_FRAME()
+#endif
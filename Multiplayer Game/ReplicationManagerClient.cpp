@@ -3,6 +3,19 @@
 
 // TODO(you): World state replication lab session
 
+// NOTE: Children go along with their parent, their own destroy commands
+// may come later (or be lost) and are then ignored
+static void destroyNetworkObject(GameObject *gameObject)
+{
+	while (GameObject *child = App->modGameObject->findNetworkChild(gameObject))
+	{
+		destroyNetworkObject(child);
+	}
+
+	App->modLinkingContext->unregisterNetworkGameObject(gameObject);
+	App->modGameObject->Destroy(gameObject);
+}
+
 void ReplicationManagerClient::read(const InputMemoryStream& packet)
 {
 	while ((int)packet.RemainingByteCount() > 0)
@@ -24,9 +37,14 @@ void ReplicationManagerClient::read(const InputMemoryStream& packet)
 		{
 			GameObject* gameObject = App->modGameObject->Instantiate();
 
-			if (App->modLinkingContext->getNetworkGameObject(networkId) != nullptr)
+			GameObject* existing = App->modLinkingContext->getNetworkGameObject(networkId);
+			if (existing != nullptr)
 			{
 				gameObject->readCreate(packet);
+				if (existing->behaviour != nullptr && gameObject->behaviour != nullptr)
+				{
+					existing->behaviour->onCreateResent(*gameObject->behaviour);
+				}
 				App->modGameObject->Destroy(gameObject);
 			}
 			else
@@ -60,8 +78,7 @@ void ReplicationManagerClient::read(const InputMemoryStream& packet)
 			GameObject* gameObject = App->modLinkingContext->getNetworkGameObject(networkId);
 			if (gameObject)
 			{
-				App->modLinkingContext->unregisterNetworkGameObject(gameObject);
-				App->modGameObject->Destroy(gameObject);
+				destroyNetworkObject(gameObject);
 			}				
 		}
 		break;
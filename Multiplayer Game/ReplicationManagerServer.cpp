@@ -40,12 +40,14 @@ void ReplicationManagerServer::destroy(uint32 networkId)
 	commands[networkId].networkId = networkId;
 }
 
-void ReplicationManagerServer::write(OutputMemoryStream& packet)
+void ReplicationManagerServer::write(OutputMemoryStream& packet, const ReplicationSnapshot &snapshot, NetworkStats *stats)
 {
 	std::vector<decltype(commands)::key_type> vec;
 
 	for (auto it = commands.begin(); it != commands.end(); ++it)
 	{
+		const uint32 commandBegin = packet.GetSize();
+
 		packet.Write(it->second.networkId);
 		packet.Write(it->second.action);
 
@@ -58,28 +60,12 @@ void ReplicationManagerServer::write(OutputMemoryStream& packet)
 		break;
 		case ReplicationAction::Create:
 		{
-			GameObject* gameObject = App->modLinkingContext->getNetworkGameObject(it->second.networkId);
-			if(gameObject)
-				gameObject->writeCreate(packet);
-			else //This is an old packet with create for a object that has already been deleted on the server so we will create for a dummy
-			{
-				GameObject* dummy = Instantiate();
-				dummy->writeCreate(packet);
-				Destroy(dummy);
-			}
+			snapshot.writeCreate(it->second.networkId, packet);
 		}
 		break;
 		case ReplicationAction::Update:
 		{
-			GameObject* gameObject = App->modLinkingContext->getNetworkGameObject(it->second.networkId);
-			if(gameObject)
-				gameObject->writeUpdate(packet);
-			else //This is an old packet with update for a object that has already been deleted on the server so we will write update for a dummy
-			{
-				GameObject* dummy = Instantiate();
-				dummy->writeUpdate(packet);
-				Destroy(dummy);
-			}
+			snapshot.writeUpdate(it->second.networkId, packet);
 		}
 		break;
 		case ReplicationAction::Destroy:
@@ -91,9 +77,118 @@ void ReplicationManagerServer::write(OutputMemoryStream& packet)
 			break;
 		}
 
+		if (stats != nullptr && (it->second.action == ReplicationAction::Create || it->second.action == ReplicationAction::Update))
+		{
+			stats->addReplicatedObject(snapshot.objectType(it->second.networkId), packet.GetSize() - commandBegin);
+		}
+
 		//This is to clear the action
 		it->second.action = ReplicationAction::None;
 	}
 	for (auto&& key : vec)
 		commands.erase(key);
 }
+
+
+//////////////////////////////////////////////////////////////////////
+// ReplicationSnapshot
+//////////////////////////////////////////////////////////////////////
+
+static void appendStream(std::vector<char> &data, const OutputMemoryStream &stream)
+{
+	data.insert(data.end(), stream.GetBufferPtr(), stream.GetBufferPtr() + stream.GetSize());
+}
+
+void ReplicationSnapshot::capture(const ReplicationManagerServer *const *managers, int managerCount)
+{
+	OutputMemoryStream stream;
+
+	if (dummyCreate.empty())
+	{
+		// Old packets may still carry creates/updates for objects that have
+		// already been deleted on the server, those write a dummy object
+		GameObject* dummy = Instantiate();
+		dummy->writeCreate(stream);
+		appendStream(dummyCreate, stream);
+		stream.Clear();
+		dummy->writeUpdate(stream);
+		appendStream(dummyUpdate, stream);
+		Destroy(dummy);
+	}
+
+	data.clear();
+
+	for (uint32 i = 0; i < capturedCount; ++i)
+	{
+		entries[capturedIndices[i]] = Entry();
+	}
+	capturedCount = 0;
+
+	for (int m = 0; m < managerCount; ++m)
+	{
+		for (const auto &pair : managers[m]->commands)
+		{
+			const ReplicationCommand &command = pair.second;
+			const bool create = (command.action == ReplicationAction::Create);
+			if (!create && command.action != ReplicationAction::Update)
+				continue;
+
+			// Objects already deleted are written as a dummy
+			GameObject *gameObject = App->modLinkingContext->getNetworkGameObject(command.networkId);
+			if (gameObject == nullptr)
+				continue;
+
+			const uint16 index = ModuleLinkingContext::arrayIndexFromNetworkId(command.networkId);
+			Entry &entry = entries[index];
+			if (entry.networkId != command.networkId)
+			{
+				entry.networkId = command.networkId;
+				entry.objectType = (uint8)(gameObject->behaviour != nullptr ? gameObject->behaviour->type() : BehaviourType::None);
+				capturedIndices[capturedCount++] = index;
+			}
+
+			if (create && !entry.hasCreate)
+			{
+				stream.Clear();
+				gameObject->writeCreate(stream);
+				entry.createOffset = (uint32)data.size();
+				entry.createSize = stream.GetSize();
+				entry.hasCreate = true;
+				appendStream(data, stream);
+			}
+			else if (!create && !entry.hasUpdate)
+			{
+				stream.Clear();
+				gameObject->writeUpdate(stream);
+				entry.updateOffset = (uint32)data.size();
+				entry.updateSize = stream.GetSize();
+				entry.hasUpdate = true;
+				appendStream(data, stream);
+			}
+		}
+	}
+}
+
+void ReplicationSnapshot::writeCreate(uint32 networkId, OutputMemoryStream &packet) const
+{
+	const Entry &entry = entries[ModuleLinkingContext::arrayIndexFromNetworkId(networkId)];
+	if (entry.networkId == networkId && entry.hasCreate)
+		packet.Write(data.data() + entry.createOffset, entry.createSize);
+	else
+		packet.Write(dummyCreate.data(), dummyCreate.size());
+}
+
+void ReplicationSnapshot::writeUpdate(uint32 networkId, OutputMemoryStream &packet) const
+{
+	const Entry &entry = entries[ModuleLinkingContext::arrayIndexFromNetworkId(networkId)];
+	if (entry.networkId == networkId && entry.hasUpdate)
+		packet.Write(data.data() + entry.updateOffset, entry.updateSize);
+	else
+		packet.Write(dummyUpdate.data(), dummyUpdate.size());
+}
+
+uint8 ReplicationSnapshot::objectType(uint32 networkId) const
+{
+	const Entry &entry = entries[ModuleLinkingContext::arrayIndexFromNetworkId(networkId)];
+	return (entry.networkId == networkId) ? entry.objectType : (uint8)BehaviourType::None;
+}
@@ -1,6 +1,55 @@
 #pragma once
 #include <unordered_map>
 
+class ReplicationManagerServer;
+
+// NOTE: Serialized create/update state of the network objects, captured
+// once per replication tick on the main thread. Replication managers only
+// copy bytes out of it, so the per-client packets can be written from the
+// task manager threads without touching the live game objects. Only the
+// records that the pending commands of the given managers will write are
+// captured, idle objects cost nothing.
+class ReplicationSnapshot
+{
+public:
+
+	void capture(const ReplicationManagerServer *const *managers, int managerCount);
+
+	void writeCreate(uint32 networkId, OutputMemoryStream &packet) const;
+	void writeUpdate(uint32 networkId, OutputMemoryStream &packet) const;
+
+	// BehaviourType of the object, for the network stats
+	uint8 objectType(uint32 networkId) const;
+
+private:
+
+	struct Entry
+	{
+		uint32 networkId = 0;
+		uint32 createOffset = 0;
+		uint32 createSize = 0;
+		uint32 updateOffset = 0;
+		uint32 updateSize = 0;
+		uint8 objectType = 0;
+		bool hasCreate = false;
+		bool hasUpdate = false;
+	};
+
+	// Indexed like the array of network objects in ModuleLinkingContext
+	Entry entries[MAX_NETWORK_OBJECTS];
+
+	// Entries filled by the last capture, to reset only those
+	uint16 capturedIndices[MAX_NETWORK_OBJECTS];
+	uint32 capturedCount = 0;
+
+	std::vector<char> data;
+
+	// Serialization of a default game object, written for objects that
+	// no longer exist on the server
+	std::vector<char> dummyCreate;
+	std::vector<char> dummyUpdate;
+};
+
 // TODO(you): World state replication lab session
 class ReplicationManagerServer
 {
@@ -10,7 +59,8 @@ public:
 	void update(uint32 networkId);
 	void destroy(uint32 networkId);
 
-	void write(OutputMemoryStream &packet);
+	// Stats are optional, to count the replicated bytes per object type
+	void write(OutputMemoryStream &packet, const ReplicationSnapshot &snapshot, NetworkStats *stats = nullptr);
 
 	std::unordered_map<uint32, ReplicationCommand> commands;
-};
\ No newline at end of file
+};
@@ -4,7 +4,7 @@
 void ScreenBackground::enable()
 {
 	background = Instantiate();
-	background->size = { 1920.f, 1080.f };
+	background->size() = { 1920.f, 1080.f };
 	background->sprite = App->modRender->addSprite(background);
 	background->sprite->texture = App->modResources->background;
 	background->sprite->order = -2;
@@ -12,7 +12,7 @@ void ScreenBackground::enable()
 
 void ScreenBackground::update()
 {
-	background->size = { (float)Window.width, (float)Window.height };
+	background->size() = { (float)Window.width, (float)Window.height };
 }
 
 void ScreenBackground::disable()
@@ -49,26 +49,18 @@ void ScreenGame::update()
 		{
 			vec2 camPos = App->modRender->cameraPosition;
 			vec2 bgSize = spaceTopLeft->sprite->texture->size;
-			spaceTopLeft->position = bgSize * floor(camPos / bgSize);
-			spaceTopRight->position = bgSize * (floor(camPos / bgSize) + vec2{ 1.0f, 0.0f });
-			spaceBottomLeft->position = bgSize * (floor(camPos / bgSize) + vec2{ 0.0f, 1.0f });
-			spaceBottomRight->position = bgSize * (floor(camPos / bgSize) + vec2{ 1.0f, 1.0f });;
+			spaceTopLeft->position() = bgSize * floor(camPos / bgSize);
+			spaceTopRight->position() = bgSize * (floor(camPos / bgSize) + vec2{ 1.0f, 0.0f });
+			spaceBottomLeft->position() = bgSize * (floor(camPos / bgSize) + vec2{ 0.0f, 1.0f });
+			spaceBottomRight->position() = bgSize * (floor(camPos / bgSize) + vec2{ 1.0f, 1.0f });;
 		}
 	}
 }
 
-bool compareLevel(const Player& first, const Player& second)
-{
-	if (first.level == second.level)
-		return (first.name < second.name);
-	else
-		return (first.level > second.level);
-}
-
 void ScreenGame::gui()
 {
-	std::list<Player> playersList = App->modBehaviour->GetPlayersList();
-	playersList.sort(compareLevel);
+	const ModuleBehaviour* behaviours = App->modBehaviour;
+	const uint32 playerCount = behaviours->rankedPlayerCount();
 
 	ImGuiWindowFlags window_flags = 0;
 	window_flags |= ImGuiWindowFlags_NoBackground;
@@ -83,28 +75,26 @@ void ScreenGame::gui()
 	bool open = true;
 	ImGui::Begin("LeaderBoard", &open, window_flags);
 
-	uint8 count = 1;
 	bool printedSelf = false;
 
 	ImGui::Columns(3, "entries", false);
 	ImGui::SetColumnWidth(0, 25);
 	ImGui::SetColumnWidth(1, 125);
 	ImGui::SetColumnWidth(2, 75);
-	for (std::list<Player>::iterator it = playersList.begin(); it != playersList.end() && count < 6; ++it)
+	for (uint32 rank = 0; rank < playerCount && rank < 5; ++rank)
 	{
-		//ImGui::Text("#%i  %s  Level %i", count, (*it).name.c_str(), (*it).level);
-		ImGui::Text("#%i",count);
+		const Player& player = behaviours->rankedPlayer(rank);
+		ImGui::Text("#%i", rank + 1);
 		ImGui::NextColumn();
-		ImGui::Text("%s", (*it).name.c_str());
+		ImGui::Text("%s", player.name.c_str());
 		ImGui::NextColumn();
-		ImGui::Text("Level %i", (*it).level);
+		ImGui::Text("Level %i", player.level);
 		ImGui::NextColumn();
 
-		if (!isServer && App->modNetClient->GetNetworkId() == (*it).gameObject->networkId)
+		if (!isServer && App->modNetClient->GetNetworkId() == player.gameObject->networkId)
 		{
 			printedSelf = true;
 		}
-		++count;
 	}
 	ImGui::Columns(1);
 	if (!isServer && !printedSelf)
@@ -114,21 +104,19 @@ void ScreenGame::gui()
 		ImGui::SetColumnWidth(0, 25);
 		ImGui::SetColumnWidth(1, 125);
 		ImGui::SetColumnWidth(2, 75);
-		count = 1;
-		for (std::list<Player>::iterator it = playersList.begin(); it != playersList.end(); ++it)
+		for (uint32 rank = 0; rank < playerCount; ++rank)
 		{
-			if (App->modNetClient->GetNetworkId() == (*it).gameObject->networkId)
+			const Player& player = behaviours->rankedPlayer(rank);
+			if (App->modNetClient->GetNetworkId() == player.gameObject->networkId)
 			{
-				//ImGui::Text("#%i  %s  Level %i", count, (*it).name.c_str(), (*it).level);
-				ImGui::Text("#%i", count);
+				ImGui::Text("#%i", rank + 1);
 				ImGui::NextColumn();
-				ImGui::Text("%s", (*it).name.c_str());
+				ImGui::Text("%s", player.name.c_str());
 				ImGui::NextColumn();
-				ImGui::Text("Level %i", (*it).level);
+				ImGui::Text("Level %i", player.level);
 				ImGui::NextColumn();
 				break;
 			}
-			++count;
 		}
 	}
 
@@ -9,9 +9,9 @@ void ScreenLoading::enable()
 		float radians = 2.0f * PI * progressRatio;
 
 		loadingBars[i] = Instantiate();
-		loadingBars[i]->position = 30.0f * vec2{ sinf(radians), cosf(radians) };
-		loadingBars[i]->angle = -360.0f * progressRatio;
-		loadingBars[i]->size = vec2{ 4, 30 };
+		loadingBars[i]->position() = 30.0f * vec2{ sinf(radians), cosf(radians) };
+		loadingBars[i]->angle() = -360.0f * progressRatio;
+		loadingBars[i]->size() = vec2{ 4, 30 };
 		loadingBars[i]->sprite = App->modRender->addSprite(loadingBars[i]);
 		loadingBars[i]->sprite->color = vec4{ 1.0f, 1.0f, 1.0f, 1.0f };
 		loadingBars[i]->sprite->pivot = vec2{ 0.5f, 0.5f };
@@ -28,7 +28,7 @@ void ScreenLoading::update()
 		gameObject->sprite->color.a = 1.0f - fractionalPart(((float)Time.time + progressRatio * ROUND_TIME)/ ROUND_TIME);
 	}
 
-	if (App->modResources->finishedLoading)
+	if (App->modResources->menuResourcesLoaded)
 	{
 		App->modScreen->swapScreensWithTransition(this, App->modScreen->screenMainMenu);
 
@@ -19,6 +19,14 @@ void ScreenMainMenu::gui()
 
 	ImGui::PushItemWidth(ImGui::GetWindowWidth() * 0.45f);
 
+	// NOTE: The sprites keep loading after the menu appears, the game can't
+	// start until they are ready
+	const bool resourcesLoaded = App->modResources->finishedLoading;
+	if (!resourcesLoaded)
+	{
+		ImGui::ProgressBar(App->modResources->loadingProgress(), ImVec2(-1.0f, 0.0f), "Loading resources...");
+	}
+
 	ImGui::Spacing();
 
 	ImGui::Text("Server");
@@ -26,7 +34,7 @@ void ScreenMainMenu::gui()
 	static int localServerPort = 8888;
 	ImGui::InputInt("Server port", &localServerPort);
 
-	if (ImGui::Button("Start server"))
+	if (ImGui::Button("Start server") && resourcesLoaded)
 	{
 		App->modScreen->screenGame->isServer = true;
 		App->modScreen->screenGame->serverPort = localServerPort;
@@ -69,7 +77,7 @@ void ScreenMainMenu::gui()
 
 	static bool showInvalidUserName = false;
 
-	if (ImGui::Button("Connect to server"))
+	if (ImGui::Button("Connect to server") && resourcesLoaded)
 	{
 		if (isValidPlayerName(playerNameStr))
 		{
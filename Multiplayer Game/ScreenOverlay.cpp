@@ -26,7 +26,7 @@ void ScreenOverlay::update()
 {
 	ASSERT(oldScene != nullptr && newScene != nullptr);
 
-	overlay->size = { (float)Window.width, (float)Window.height };
+	overlay->size() = { (float)Window.width, (float)Window.height };
 
 	const float halfTransitionTime = transitionTimeMax * 0.5f;
 
@@ -0,0 +1,65 @@
+#include "Networks.h"
+#include "SpriteBatch.h"
+
+void SpriteBatch::begin()
+{
+	vertexCount = 0;
+	runCount = 0;
+}
+
+void SpriteBatch::addSprite(Texture *texture, vec2 position, vec2 size, vec2 pivot, float angle, vec4 uvRect, vec4 color)
+{
+	ASSERT(vertexCount + VERTICES_PER_QUAD <= MAX_VERTICES);
+
+	// Start a new run when the texture changes
+	if (runCount == 0 || runs[runCount - 1].texture != texture)
+	{
+		SpriteBatchRun &run = runs[runCount++];
+		run.texture = texture;
+		run.firstVertex = vertexCount;
+		run.vertexCount = 0;
+	}
+
+	// Same transform the shaders used to apply per sprite: pivot offset,
+	// scale, rotation around Z, and translation
+	const float radians = radiansFromDegrees(angle);
+	const float c = cosf(radians);
+	const float s = sinf(radians);
+
+	const float x0 = (-pivot.x) * size.x;
+	const float x1 = (1.0f - pivot.x) * size.x;
+	const float y0 = (-pivot.y) * size.y;
+	const float y1 = (1.0f - pivot.y) * size.y;
+
+	const float u0 = uvRect.x;
+	const float u1 = uvRect.x + uvRect.z;
+	const float v0 = uvRect.y;
+	const float v1 = uvRect.y + uvRect.w;
+
+	struct Corner { float x, y, u, v; };
+	const Corner corners[VERTICES_PER_QUAD] = {
+		{ x0, y0, u0, v0 },
+		{ x0, y1, u0, v1 },
+		{ x1, y1, u1, v1 },
+		{ x0, y0, u0, v0 },
+		{ x1, y1, u1, v1 },
+		{ x1, y0, u1, v0 },
+	};
+
+	SpriteVertex *vertex = &vertices[vertexCount];
+	for (const Corner &corner : corners)
+	{
+		vertex->x = position.x + corner.x * c - corner.y * s;
+		vertex->y = position.y + corner.x * s + corner.y * c;
+		vertex->u = corner.u;
+		vertex->v = corner.v;
+		vertex->r = color.r;
+		vertex->g = color.g;
+		vertex->b = color.b;
+		vertex->a = color.a;
+		vertex++;
+	}
+
+	vertexCount += VERTICES_PER_QUAD;
+	runs[runCount - 1].vertexCount += VERTICES_PER_QUAD;
+}
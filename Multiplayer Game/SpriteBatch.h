@@ -0,0 +1,52 @@
+#pragma once
+
+struct Texture;
+
+// NOTE: Platform independent builder of sprite geometry. Sprites are
+// added already sorted in drawing order, their quads are transformed to
+// world space on the CPU, and consecutive sprites sharing texture are
+// grouped into runs. The render backend then uploads all the vertices
+// at once and issues one draw call per run.
+
+struct SpriteVertex
+{
+	float x, y;
+	float u, v;
+	float r, g, b, a;
+};
+
+struct SpriteBatchRun
+{
+	Texture *texture = nullptr;
+	uint32 firstVertex = 0;
+	uint32 vertexCount = 0;
+};
+
+class SpriteBatch
+{
+public:
+
+	static const uint32 MAX_QUADS = MAX_GAME_OBJECTS + MAX_COLLIDERS;
+	static const uint32 VERTICES_PER_QUAD = 6;
+	static const uint32 MAX_VERTICES = MAX_QUADS * VERTICES_PER_QUAD;
+
+	void begin();
+
+	// position and size in world units, angle in degrees, uvRect as
+	// {u, v, width, height} like AnimationClip::frameRect
+	void addSprite(Texture *texture, vec2 position, vec2 size, vec2 pivot, float angle, vec4 uvRect, vec4 color);
+
+	const SpriteVertex *getVertices() const { return vertices; }
+	uint32 getVertexCount() const { return vertexCount; }
+
+	const SpriteBatchRun *getRuns() const { return runs; }
+	uint32 getRunCount() const { return runCount; }
+
+private:
+
+	SpriteVertex vertices[MAX_VERTICES];
+	uint32 vertexCount = 0;
+
+	SpriteBatchRun runs[MAX_QUADS];
+	uint32 runCount = 0;
+};
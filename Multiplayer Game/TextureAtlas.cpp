@@ -0,0 +1,298 @@
+#include "Networks.h"
+#include "TextureAtlas.h"
+
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "imgui/imstb_rectpack.h"
+
+
+//////////////////////////////////////////////////////////////////////
+// File format
+//////////////////////////////////////////////////////////////////////
+
+// NOTE: Plain structs written as they are in memory, the file is only
+// meant to be read back by the same build on the same machine.
+//   AtlasFileHeader
+//   AtlasFilePage[pageCount]
+//   TextureAtlas::Region[regionCount]
+//   pixels of each page, at AtlasFilePage::pixelsOffset
+
+static const uint32 ATLAS_FILE_MAGIC = 'ATLS';
+static const uint32 ATLAS_FILE_VERSION = 1;
+
+struct AtlasFileHeader
+{
+	uint32 magic;
+	uint32 version;
+	uint32 pageCount;
+	uint32 regionCount;
+};
+
+struct AtlasFilePage
+{
+	int32 width;
+	int32 height;
+	uint64 pixelsOffset;
+};
+
+
+//////////////////////////////////////////////////////////////////////
+// TextureAtlas
+//////////////////////////////////////////////////////////////////////
+
+static void blitWithPadding(uint8 *page, int pageWidth, const AtlasImage &image, int x, int y, int padding)
+{
+	// Copy the image surrounded by a border that repeats its edge pixels,
+	// so that linear filtering doesn't bleed the neighbours in
+	for (int dy = -padding; dy < image.height + padding; ++dy)
+	{
+		const int sy = max(0, min(dy, image.height - 1));
+		for (int dx = -padding; dx < image.width + padding; ++dx)
+		{
+			const int sx = max(0, min(dx, image.width - 1));
+			const uint8 *src = image.pixels + (sy * image.width + sx) * 4;
+			uint8 *dst = page + ((y + dy) * pageWidth + (x + dx)) * 4;
+			memcpy(dst, src, 4);
+		}
+	}
+}
+
+bool TextureAtlas::build(const AtlasImage *images, uint32 imageCount)
+{
+	clear();
+
+	if (imageCount > MAX_REGIONS)
+	{
+		ELOG("TextureAtlas::build() - too many images (%u)", imageCount);
+		return false;
+	}
+
+	stbrp_rect rects[MAX_REGIONS];
+	int rectCount = 0;
+
+	for (uint32 i = 0; i < imageCount; ++i)
+	{
+		const AtlasImage &image = images[i];
+		Region &region = regions[i];
+		strncpy(region.name, image.name, MAX_NAME_LENGTH - 1);
+		region.sourceHash = image.sourceHash;
+		region.width = image.width;
+		region.height = image.height;
+
+		if (image.width > MAX_PACKED_SIZE || image.height > MAX_PACKED_SIZE)
+		{
+			// Page of its own, same size as the image
+			if (pageCount == MAX_PAGES) { clear(); return false; }
+			region.page = pageCount++;
+			pages[region.page].width = image.width;
+			pages[region.page].height = image.height;
+			pagePixels[region.page].assign(image.pixels, image.pixels + image.width * image.height * 4);
+		}
+		else
+		{
+			stbrp_rect &rect = rects[rectCount++];
+			rect.id = (int)i;
+			rect.w = (stbrp_coord)(image.width + 2 * PADDING);
+			rect.h = (stbrp_coord)(image.height + 2 * PADDING);
+			rect.was_packed = 0;
+		}
+	}
+	regionCount = imageCount;
+
+	// Fill shared pages until all the small images are packed
+	stbrp_node nodes[PAGE_SIZE];
+	while (rectCount > 0)
+	{
+		if (pageCount == MAX_PAGES) { clear(); return false; }
+		const uint32 pageIndex = pageCount++;
+
+		stbrp_context context;
+		stbrp_init_target(&context, PAGE_SIZE, PAGE_SIZE, nodes, PAGE_SIZE);
+		stbrp_pack_rects(&context, rects, rectCount);
+
+		// Trim the unused bottom of the page
+		int usedHeight = 0;
+		for (int i = 0; i < rectCount; ++i)
+		{
+			if (rects[i].was_packed) usedHeight = max(usedHeight, (int)(rects[i].y + rects[i].h));
+		}
+		if (usedHeight == 0) { clear(); return false; } // Nothing fits
+
+		Page &page = pages[pageIndex];
+		page.width = PAGE_SIZE;
+		page.height = usedHeight;
+		pagePixels[pageIndex].assign(page.width * page.height * 4, 0);
+
+		int remainingCount = 0;
+		for (int i = 0; i < rectCount; ++i)
+		{
+			if (rects[i].was_packed)
+			{
+				Region &region = regions[rects[i].id];
+				region.page = pageIndex;
+				region.x = rects[i].x + PADDING;
+				region.y = rects[i].y + PADDING;
+				blitWithPadding(pagePixels[pageIndex].data(), page.width, images[rects[i].id], region.x, region.y, PADDING);
+			}
+			else
+			{
+				rects[remainingCount++] = rects[i];
+			}
+		}
+		rectCount = remainingCount;
+	}
+
+	for (uint32 i = 0; i < pageCount; ++i)
+	{
+		pages[i].pixels = pagePixels[i].data();
+	}
+
+	return true;
+}
+
+bool TextureAtlas::save(const char *filename) const
+{
+	FILE *f = fopen(filename, "wb");
+	if (f == nullptr)
+	{
+		WLOG("TextureAtlas::save() - could not open %s", filename);
+		return false;
+	}
+
+	AtlasFileHeader header = {};
+	header.magic = ATLAS_FILE_MAGIC;
+	header.version = ATLAS_FILE_VERSION;
+	header.pageCount = pageCount;
+	header.regionCount = regionCount;
+
+	// Pixels start after the tables, each page 16-byte aligned
+	uint64 offset = sizeof(AtlasFileHeader) + sizeof(AtlasFilePage) * pageCount + sizeof(Region) * regionCount;
+	AtlasFilePage filePages[MAX_PAGES] = {};
+	for (uint32 i = 0; i < pageCount; ++i)
+	{
+		offset = (offset + 15) & ~15ull;
+		filePages[i].width = pages[i].width;
+		filePages[i].height = pages[i].height;
+		filePages[i].pixelsOffset = offset;
+		offset += (uint64)pages[i].width * pages[i].height * 4;
+	}
+
+	bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+	ok = ok && fwrite(filePages, sizeof(AtlasFilePage), pageCount, f) == pageCount;
+	ok = ok && fwrite(regions, sizeof(Region), regionCount, f) == regionCount;
+	for (uint32 i = 0; ok && i < pageCount; ++i)
+	{
+		static const uint8 zeros[16] = {};
+		const size_t paddingSize = (size_t)(filePages[i].pixelsOffset - (uint64)ftell(f));
+		ok = paddingSize == 0 || fwrite(zeros, 1, paddingSize, f) == paddingSize;
+		const size_t pixelsSize = (size_t)pages[i].width * pages[i].height * 4;
+		ok = ok && fwrite(pages[i].pixels, 1, pixelsSize, f) == pixelsSize;
+	}
+
+	fclose(f);
+
+	if (!ok)
+	{
+		WLOG("TextureAtlas::save() - could not write %s", filename);
+		remove(filename);
+	}
+
+	return ok;
+}
+
+bool TextureAtlas::load(const char *filename)
+{
+	clear();
+
+	if (!file.open(filename))
+	{
+		return false;
+	}
+
+	const uint8 *data = file.data();
+	const uint64 size = file.size();
+
+	const AtlasFileHeader *header = (const AtlasFileHeader *)data;
+	if (size < sizeof(AtlasFileHeader) ||
+		header->magic != ATLAS_FILE_MAGIC ||
+		header->version != ATLAS_FILE_VERSION ||
+		header->pageCount > MAX_PAGES ||
+		header->regionCount > MAX_REGIONS ||
+		size < sizeof(AtlasFileHeader) + sizeof(AtlasFilePage) * header->pageCount + sizeof(Region) * header->regionCount)
+	{
+		clear();
+		return false;
+	}
+
+	const AtlasFilePage *filePages = (const AtlasFilePage *)(header + 1);
+	for (uint32 i = 0; i < header->pageCount; ++i)
+	{
+		const uint64 pixelsSize = (uint64)filePages[i].width * filePages[i].height * 4;
+		if (filePages[i].pixelsOffset + pixelsSize > size)
+		{
+			clear();
+			return false;
+		}
+
+		pages[i].width = filePages[i].width;
+		pages[i].height = filePages[i].height;
+		pages[i].pixels = data + filePages[i].pixelsOffset;
+	}
+	pageCount = header->pageCount;
+
+	const Region *fileRegions = (const Region *)(filePages + header->pageCount);
+	for (uint32 i = 0; i < header->regionCount; ++i)
+	{
+		regions[i] = fileRegions[i];
+		regions[i].name[MAX_NAME_LENGTH - 1] = '\0';
+		if (regions[i].page >= pageCount)
+		{
+			clear();
+			return false;
+		}
+	}
+	regionCount = header->regionCount;
+
+	return true;
+}
+
+void TextureAtlas::clear()
+{
+	for (uint32 i = 0; i < MAX_PAGES; ++i)
+	{
+		pages[i] = Page();
+		pagePixels[i].clear();
+		pagePixels[i].shrink_to_fit();
+	}
+	pageCount = 0;
+
+	for (uint32 i = 0; i < MAX_REGIONS; ++i)
+	{
+		regions[i] = Region();
+	}
+	regionCount = 0;
+
+	file.close();
+}
+
+const TextureAtlas::Region * TextureAtlas::findRegion(const char *name) const
+{
+	for (uint32 i = 0; i < regionCount; ++i)
+	{
+		if (strcmp(regions[i].name, name) == 0)
+		{
+			return &regions[i];
+		}
+	}
+	return nullptr;
+}
+
+vec4 TextureAtlas::regionUVRect(const Region &region) const
+{
+	const Page &page = pages[region.page];
+	return vec4{
+		(float)region.x / page.width,
+		(float)region.y / page.height,
+		(float)region.width / page.width,
+		(float)region.height / page.height };
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+// NOTE: Packs many RGBA8 images into a few atlas pages, and saves/loads the
+// result as a pre-decoded binary file that is memory mapped when loaded,
+// so the pixels can be uploaded straight from the file without decoding.
+// It doesn't know anything about the graphics API, ModuleTextures creates
+// the textures from the pages.
+
+struct AtlasImage
+{
+	const char *name = nullptr;
+	const uint8 *pixels = nullptr; // RGBA8
+	int width = 0;
+	int height = 0;
+	uint64 sourceHash = 0;         // Identifies the contents of the source file
+};
+
+class TextureAtlas
+{
+public:
+
+	static const uint32 MAX_PAGES = 8;
+	static const uint32 MAX_REGIONS = 64;
+	static const uint32 MAX_NAME_LENGTH = 64;
+	static const int PAGE_SIZE = 2048;
+	static const int MAX_PACKED_SIZE = 1024; // Bigger images get a page of their own
+	static const int PADDING = 1;            // Border of repeated edge pixels
+
+	struct Page
+	{
+		int width = 0;
+		int height = 0;
+		const uint8 *pixels = nullptr;
+	};
+
+	struct Region
+	{
+		char name[MAX_NAME_LENGTH] = {};
+		uint64 sourceHash = 0;
+		uint32 page = 0;
+		int x = 0;
+		int y = 0;
+		int width = 0;
+		int height = 0;
+	};
+
+	bool build(const AtlasImage *images, uint32 imageCount);
+
+	bool save(const char *filename) const;
+
+	bool load(const char *filename);
+
+	void clear();
+
+	const Region *findRegion(const char *name) const;
+
+	// Normalized {u, v, width, height} of a region within its page
+	vec4 regionUVRect(const Region &region) const;
+
+	uint32 pageCount = 0;
+	Page pages[MAX_PAGES];
+
+	uint32 regionCount = 0;
+	Region regions[MAX_REGIONS];
+
+private:
+
+	// Pixels of the pages when built, they point into the file when loaded
+	std::vector<uint8> pagePixels[MAX_PAGES];
+	MappedFile file;
+};
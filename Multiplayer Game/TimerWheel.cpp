@@ -0,0 +1,199 @@
+#include "Networks.h"
+#include "TimerWheel.h"
+
+TimerWheel::TimerWheel()
+{
+	clear();
+}
+
+void TimerWheel::clear(double time)
+{
+	for (Timer &timer : timers)
+	{
+		timer = {};
+	}
+
+	for (uint32 &list : lists)
+	{
+		list = INVALID_INDEX;
+	}
+
+	expiredTail = INVALID_INDEX;
+
+	currentTick = tickFromTime(time);
+}
+
+void TimerWheel::schedule(uint32 id, double expirationTime)
+{
+	ASSERT(id < MAX_TIMERS);
+
+	// NOTE: Round up so timers never fire before their expiration time,
+	// and never schedule in a tick that has already been processed.
+	uint64 expirationTick = (uint64)ceil(max(expirationTime, 0.0) / TIMER_WHEEL_TICK_SECONDS);
+	expirationTick = max(expirationTick, currentTick + 1);
+
+	Timer &timer = timers[id];
+
+	if (timer.list != INVALID_INDEX)
+	{
+		if (timer.list == EXPIRED_LIST || timer.expirationTick <= expirationTick)
+		{
+			return; // Already due earlier
+		}
+
+		unlink(id);
+	}
+
+	timer.expirationTick = expirationTick;
+	insert(id);
+}
+
+void TimerWheel::cancel(uint32 id)
+{
+	ASSERT(id < MAX_TIMERS);
+
+	if (timers[id].list != INVALID_INDEX)
+	{
+		unlink(id);
+	}
+}
+
+bool TimerWheel::isScheduled(uint32 id) const
+{
+	ASSERT(id < MAX_TIMERS);
+	return timers[id].list != INVALID_INDEX;
+}
+
+void TimerWheel::advance(double time)
+{
+	const uint64 targetTick = tickFromTime(time);
+
+	while (currentTick < targetTick)
+	{
+		currentTick++;
+
+		// Once per rotation of the inner level, redistribute the timers
+		// of the outer level slot that starts now
+		if ((currentTick & SLOT_MASK) == 0)
+		{
+			uint32 list = SLOT_COUNT + ((currentTick >> SLOT_BITS) & SLOT_MASK);
+			while (lists[list] != INVALID_INDEX)
+			{
+				uint32 id = lists[list];
+				unlink(id);
+				insert(id);
+			}
+		}
+
+		// Move the expired timers to the expired list
+		uint32 list = (uint32)(currentTick & SLOT_MASK);
+		while (lists[list] != INVALID_INDEX)
+		{
+			uint32 id = lists[list];
+			unlink(id);
+			link(id, EXPIRED_LIST);
+		}
+	}
+}
+
+bool TimerWheel::popExpired(uint32 *id)
+{
+	if (lists[EXPIRED_LIST] == INVALID_INDEX)
+	{
+		return false;
+	}
+
+	*id = lists[EXPIRED_LIST];
+	unlink(*id);
+	return true;
+}
+
+uint64 TimerWheel::tickFromTime(double time) const
+{
+	// NOTE: Small epsilon to absorb the error accumulated in Time.time
+	return (uint64)floor(max(time, 0.0) / TIMER_WHEEL_TICK_SECONDS + 1e-6);
+}
+
+void TimerWheel::insert(uint32 id)
+{
+	const uint64 expirationTick = timers[id].expirationTick;
+	const uint64 delta = expirationTick > currentTick ? expirationTick - currentTick : 0;
+
+	uint32 list;
+	if (delta < SLOT_COUNT)
+	{
+		list = (uint32)(expirationTick & SLOT_MASK);
+	}
+	else if (delta < SLOT_COUNT * SLOT_COUNT)
+	{
+		list = SLOT_COUNT + (uint32)((expirationTick >> SLOT_BITS) & SLOT_MASK);
+	}
+	else
+	{
+		// NOTE: Too far away, park it in the last outer slot. It will be
+		// reinserted (and parked again if needed) when that slot cascades.
+		list = SLOT_COUNT + (uint32)(((currentTick >> SLOT_BITS) + SLOT_MASK) & SLOT_MASK);
+	}
+
+	link(id, list);
+}
+
+void TimerWheel::link(uint32 id, uint32 list)
+{
+	Timer &timer = timers[id];
+	timer.list = list;
+	timer.next = INVALID_INDEX;
+
+	if (list == EXPIRED_LIST)
+	{
+		// NOTE: Expired timers are appended so they pop in expiration order
+		timer.prev = expiredTail;
+		if (expiredTail != INVALID_INDEX)
+		{
+			timers[expiredTail].next = id;
+		}
+		else
+		{
+			lists[list] = id;
+		}
+		expiredTail = id;
+	}
+	else
+	{
+		timer.prev = INVALID_INDEX;
+		timer.next = lists[list];
+		if (timer.next != INVALID_INDEX)
+		{
+			timers[timer.next].prev = id;
+		}
+		lists[list] = id;
+	}
+}
+
+void TimerWheel::unlink(uint32 id)
+{
+	Timer &timer = timers[id];
+	ASSERT(timer.list != INVALID_INDEX);
+
+	if (timer.prev != INVALID_INDEX)
+	{
+		timers[timer.prev].next = timer.next;
+	}
+	else
+	{
+		lists[timer.list] = timer.next;
+	}
+
+	if (timer.next != INVALID_INDEX)
+	{
+		timers[timer.next].prev = timer.prev;
+	}
+	else if (timer.list == EXPIRED_LIST)
+	{
+		expiredTail = timer.prev;
+	}
+
+	timer.prev = INVALID_INDEX;
+	timer.next = INVALID_INDEX;
+	timer.list = INVALID_INDEX;
+}
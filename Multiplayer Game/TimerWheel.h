@@ -0,0 +1,62 @@
+#pragma once
+
+// NOTE: Hierarchical timing wheel keyed by a small integer id (e.g. the
+// id of a GameObject). Each id can have at most one pending timer.
+// - schedule() is O(1), and scheduling an already pending id only moves
+//   it if the new expiration time is earlier.
+// - cancel() is O(1).
+// - advance() costs O(elapsed ticks + expired timers), the timers stored
+//   in the outer level are cascaded into the inner one once per rotation.
+
+class TimerWheel
+{
+public:
+
+	TimerWheel();
+
+	// Removes all pending timers and restarts the wheel at the given time
+	void clear(double time = 0.0);
+
+	// Schedules (or reschedules to an earlier time) the timer for id
+	void schedule(uint32 id, double expirationTime);
+
+	void cancel(uint32 id);
+
+	bool isScheduled(uint32 id) const;
+
+	// Moves the wheel forward up to the given time. The timers that
+	// expired can be retrieved afterwards calling popExpired()
+	void advance(double time);
+
+	bool popExpired(uint32 *id);
+
+private:
+
+	static const uint32 SLOT_BITS = 8;
+	static const uint32 SLOT_COUNT = 1 << SLOT_BITS;
+	static const uint32 SLOT_MASK = SLOT_COUNT - 1;
+	static const uint32 LEVEL_COUNT = 2;
+	static const uint32 EXPIRED_LIST = SLOT_COUNT * LEVEL_COUNT;
+	static const uint32 LIST_COUNT = EXPIRED_LIST + 1;
+	static const uint32 INVALID_INDEX = 0xffffffff;
+
+	struct Timer
+	{
+		uint64 expirationTick = 0;
+		uint32 prev = INVALID_INDEX;
+		uint32 next = INVALID_INDEX;
+		uint32 list = INVALID_INDEX; // NOTE: INVALID_INDEX means not scheduled
+	};
+
+	uint64 tickFromTime(double time) const;
+
+	void insert(uint32 id);
+	void link(uint32 id, uint32 list);
+	void unlink(uint32 id);
+
+	Timer timers[MAX_TIMERS];
+	uint32 lists[LIST_COUNT];
+	uint32 expiredTail = INVALID_INDEX;
+
+	uint64 currentTick = 0;
+};
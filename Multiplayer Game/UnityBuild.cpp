@@ -2,9 +2,16 @@
 
 #include "Networks.h"
 
+#include "Log.cpp"
+#include "Profiler.cpp"
 #include "Behaviours.cpp"
 #include "DeliveryManager.cpp"
 #include "MemoryStream.cpp"
+#include "NetworkStats.cpp"
+#include "NetworkSimulator.cpp"
+#include "ConnectionGuard.cpp"
+#include "MessageChannels.cpp"
+#include "GameEvents.cpp"
 #include "ModuleNetworking.cpp"
 #include "ModuleNetworkingCommons.cpp"
 #include "ModuleNetworkingClient.cpp"
@@ -29,5 +36,10 @@
 #include "ScreenOverlay.cpp"
 #include "ScreenMainMenu.cpp"
 #include "ScreenGame.cpp"
+#include "SpriteBatch.cpp"
+#include "MappedFile.cpp"
+#include "AssetCache.cpp"
+#include "TextureAtlas.cpp"
+#include "TimerWheel.cpp"
 #include "Application.cpp"
 #include "main.cpp"
@@ -24,6 +24,10 @@ int main(int argc, char **argv)
 
 	MainState state = MainState::Create;
 
+	startLogThread("log.txt");
+
+	PROFILE_THREAD_NAME("Main");
+
 	while (state != MainState::Exit)
 	{
 		switch (state)
@@ -80,5 +84,7 @@ int main(int argc, char **argv)
 		}
 	}
 
+	stopLogThread();
+
 	return result;
 }
@@ -27,6 +27,9 @@
 
 #include <fstream>
 #include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
 #include <mutex>
 #include <condition_variable>
 #include <vector>
@@ -40,6 +43,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
+#include <float.h>
 #include <assert.h>
 #include <math.h>  // ldexp, pow
 